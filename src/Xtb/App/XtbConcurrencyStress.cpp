@@ -0,0 +1,111 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Benchmark/ConcurrencyStress.h"
+#include "Xtb/Wrapper/XtbCalculatorBase.h"
+/* External Includes */
+#include <Utils/IO/ChemicalFileFormats/ChemicalFileHandler.h>
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+void usage() {
+  std::cout << "Usage: scine_xtb_concurrency_stress [--methods METHOD[,METHOD...]] [--threads N] [--calculators N]\n"
+            << "                                    [--repetitions N] STRUCTURE [STRUCTURE...]\n";
+}
+
+std::vector<std::string> split(const std::string& value) {
+  std::vector<std::string> entries;
+  std::size_t start = 0;
+  while (start <= value.size()) {
+    const auto end = std::min(value.find(',', start), value.size());
+    if (end > start) {
+      entries.push_back(value.substr(start, end - start));
+    }
+    start = end + 1;
+  }
+  return entries;
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+  using namespace Scine;
+  using namespace Scine::Xtb;
+  namespace Names = ConcurrencyStressSettingsNames;
+  std::vector<std::string> methods = {"GFN0", "GFN1", "GFN2", "GFNFF"};
+  std::vector<std::string> structureFiles;
+  // The settings given on the command line, applied once the calculators exist
+  std::vector<std::pair<std::string, int>> intSettings;
+  try {
+    for (int i = 1; i < argc; ++i) {
+      const std::string option = argv[i];
+      if (option == "--help" || option == "-h") {
+        usage();
+        return 0;
+      }
+      if (option.compare(0, 2, "--") != 0) {
+        structureFiles.push_back(option);
+        continue;
+      }
+      if (i + 1 >= argc) {
+        throw std::invalid_argument("The option " + option + " needs a value.");
+      }
+      const std::string value = argv[++i];
+      if (option == "--methods") {
+        methods = split(value);
+      }
+      else if (option == "--threads") {
+        intSettings.emplace_back(Names::numberOfThreads, std::stoi(value));
+      }
+      else if (option == "--calculators") {
+        intSettings.emplace_back(Names::calculatorsPerThread, std::stoi(value));
+      }
+      else if (option == "--repetitions") {
+        intSettings.emplace_back(Names::repetitions, std::stoi(value));
+      }
+      else {
+        throw std::invalid_argument("Unknown option " + option + ".");
+      }
+    }
+    if (structureFiles.empty()) {
+      throw std::invalid_argument("At least one structure file is required.");
+    }
+  }
+  catch (const std::exception& e) {
+    std::cerr << e.what() << "\n";
+    usage();
+    return 1;
+  }
+
+  try {
+    std::vector<Utils::AtomCollection> structures;
+    for (const auto& file : structureFiles) {
+      structures.push_back(Utils::ChemicalFileHandler::read(file).first);
+    }
+    std::vector<std::shared_ptr<XtbCalculatorBase>> calculators;
+    for (const auto& method : methods) {
+      calculators.push_back(XtbCalculatorBase::create(method));
+    }
+    ConcurrencyStress stress(std::move(calculators));
+    for (const auto& setting : intSettings) {
+      stress.settings().modifyInt(setting.first, setting.second);
+    }
+    const auto result = stress.run(structures);
+    ConcurrencyStress::report(result, std::cout);
+    return result.passed() ? 0 : 1;
+  }
+  catch (const std::exception& e) {
+    std::cerr << "The stress run failed: " << e.what() << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,106 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Server/CalculationServer.h"
+/* External Includes */
+#include <algorithm>
+#include <csignal>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+Scine::Xtb::CalculationServer* server = nullptr;
+
+extern "C" void stopServer(int /* signal */) {
+  if (server) {
+    server->stop();
+  }
+}
+
+void usage() {
+  std::cout << "Usage: scine_xtb_server [--socket PATH] [--workers N] [--threads N] [--sessions N] [--cache N]\n"
+            << "                        [--timeout SECONDS] [--warm METHOD[,METHOD...]]\n";
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+  using namespace Scine::Xtb;
+  namespace Names = CalculationServerSettingsNames;
+  CalculationServer calculationServer;
+  auto& settings = calculationServer.settings();
+  try {
+    for (int i = 1; i < argc; ++i) {
+      const std::string option = argv[i];
+      if (option == "--help" || option == "-h") {
+        usage();
+        return 0;
+      }
+      if (i + 1 >= argc) {
+        throw std::invalid_argument("The option " + option + " needs a value.");
+      }
+      const std::string value = argv[++i];
+      if (option == "--socket") {
+        settings.modifyString(Names::socketPath, value);
+      }
+      else if (option == "--workers") {
+        settings.modifyInt(Names::workers, std::stoi(value));
+      }
+      else if (option == "--threads") {
+        settings.modifyInt(Names::threadsPerWorker, std::stoi(value));
+      }
+      else if (option == "--sessions") {
+        settings.modifyInt(Names::sessionsPerWorker, std::stoi(value));
+      }
+      else if (option == "--cache") {
+        settings.modifyInt(Names::cacheSize, std::stoi(value));
+      }
+      else if (option == "--timeout") {
+        settings.modifyDouble(Names::connectionTimeout, std::stod(value));
+      }
+      else if (option == "--warm") {
+        std::vector<std::string> methods;
+        std::size_t start = 0;
+        while (start <= value.size()) {
+          const auto end = std::min(value.find(',', start), value.size());
+          if (end > start) {
+            methods.push_back(value.substr(start, end - start));
+          }
+          start = end + 1;
+        }
+        settings.modifyStringList(Names::warmMethods, methods);
+      }
+      else {
+        throw std::invalid_argument("Unknown option " + option + ".");
+      }
+    }
+  }
+  catch (const std::exception& e) {
+    std::cerr << e.what() << "\n";
+    usage();
+    return 1;
+  }
+
+  server = &calculationServer;
+  std::signal(SIGINT, stopServer);
+  std::signal(SIGTERM, stopServer);
+  try {
+    std::cout << "Listening on " << settings.getString(Names::socketPath) << std::endl;
+    calculationServer.run();
+  }
+  catch (const std::exception& e) {
+    std::cerr << "The server failed: " << e.what() << std::endl;
+    return 1;
+  }
+  const auto statistics = calculationServer.statistics();
+  std::cout << statistics.connections << " connections, " << statistics.requests << " requests, "
+            << statistics.cacheHits << " cache hits, " << statistics.sessionHits << " session hits, "
+            << statistics.failures << " failures" << std::endl;
+  return 0;
+}
@@ -0,0 +1,155 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Benchmark/StartupBenchmark.h"
+/* External Includes */
+#include <Utils/IO/ChemicalFileFormats/ChemicalFileHandler.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+void usage() {
+  std::cout << "Usage: scine_xtb_startup_benchmark [--methods METHOD[,METHOD...]] [--constructions N] [--in-process]\n"
+            << "                                   STRUCTURE\n";
+}
+
+std::vector<std::string> split(const std::string& value) {
+  std::vector<std::string> entries;
+  std::size_t start = 0;
+  while (start <= value.size()) {
+    const auto end = std::min(value.find(',', start), value.size());
+    if (end > start) {
+      entries.push_back(value.substr(start, end - start));
+    }
+    start = end + 1;
+  }
+  return entries;
+}
+
+// Runs this executable for one method in a fresh process, returns its exit code
+int runChild(const std::string& executable, std::vector<std::string> arguments) {
+  std::vector<char*> argv;
+  argv.push_back(const_cast<char*>(executable.c_str()));
+  for (auto& argument : arguments) {
+    argv.push_back(&argument[0]);
+  }
+  argv.push_back(nullptr);
+  std::cout.flush();
+  const pid_t pid = fork();
+  if (pid < 0) {
+    throw std::runtime_error("Could not fork: " + std::string(std::strerror(errno)));
+  }
+  if (pid == 0) {
+    execvp(argv[0], argv.data());
+    std::cerr << "Could not run " << executable << ": " << std::strerror(errno) << std::endl;
+    _exit(127);
+  }
+  int status = 0;
+  while (waitpid(pid, &status, 0) < 0) {
+    if (errno != EINTR) {
+      throw std::runtime_error("Could not wait for the benchmark process: " + std::string(std::strerror(errno)));
+    }
+  }
+  return WIFEXITED(status) ? WEXITSTATUS(status) : 128;
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+  using namespace Scine;
+  using namespace Scine::Xtb;
+  namespace Names = StartupBenchmarkSettingsNames;
+  std::vector<std::string> methods = {"GFN0", "GFN1", "GFN2", "GFNFF"};
+  int constructions = 0;
+  std::string structureFile;
+  bool inProcess = false;
+  try {
+    for (int i = 1; i < argc; ++i) {
+      const std::string option = argv[i];
+      if (option == "--help" || option == "-h") {
+        usage();
+        return 0;
+      }
+      if (option == "--in-process") {
+        inProcess = true;
+        continue;
+      }
+      if (option.compare(0, 2, "--") != 0) {
+        if (!structureFile.empty()) {
+          throw std::invalid_argument("Only one structure file can be given.");
+        }
+        structureFile = option;
+        continue;
+      }
+      if (i + 1 >= argc) {
+        throw std::invalid_argument("The option " + option + " needs a value.");
+      }
+      const std::string value = argv[++i];
+      if (option == "--methods") {
+        methods = split(value);
+      }
+      else if (option == "--constructions") {
+        constructions = std::stoi(value);
+      }
+      else {
+        throw std::invalid_argument("Unknown option " + option + ".");
+      }
+    }
+    if (structureFile.empty()) {
+      throw std::invalid_argument("A structure file is required.");
+    }
+  }
+  catch (const std::exception& e) {
+    std::cerr << e.what() << "\n";
+    usage();
+    return 1;
+  }
+
+  try {
+    if (inProcess) {
+      StartupBenchmark benchmark;
+      benchmark.settings().modifyStringList(Names::methods, methods);
+      if (constructions > 0) {
+        benchmark.settings().modifyInt(Names::constructions, constructions);
+      }
+      const auto result = benchmark.run(Utils::ChemicalFileHandler::read(structureFile).first);
+      StartupBenchmark::writeTable(result, std::cout);
+      return result.passed() ? 0 : 1;
+    }
+    // Each method in a fresh process, the wall time of which includes loading the module
+    bool passed = true;
+    for (const auto& method : methods) {
+      std::vector<std::string> arguments = {"--in-process", "--methods", method};
+      if (constructions > 0) {
+        arguments.insert(arguments.end(), {"--constructions", std::to_string(constructions)});
+      }
+      arguments.push_back(structureFile);
+      const auto start = std::chrono::steady_clock::now();
+      const int status = runChild(argv[0], std::move(arguments));
+      const double wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      std::cout << "Process wall time of " << method << " (start to exit, including loading the module): "
+                << std::fixed << std::setprecision(4) << wallTime << " s\n"
+                << std::endl;
+      passed = passed && status == 0;
+    }
+    return passed ? 0 : 1;
+  }
+  catch (const std::exception& e) {
+    std::cerr << "The benchmark failed: " << e.what() << std::endl;
+    return 1;
+  }
+}
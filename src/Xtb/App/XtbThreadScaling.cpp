@@ -0,0 +1,142 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Benchmark/ThreadScalingBenchmark.h"
+#include "Xtb/Wrapper/XtbCalculatorBase.h"
+/* External Includes */
+#include <Utils/IO/ChemicalFileFormats/ChemicalFileHandler.h>
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+void usage() {
+  std::cout << "Usage: scine_xtb_thread_scaling [--methods METHOD[,METHOD...]] [--workers N[,N...]]\n"
+            << "                                [--threads N[,N...]] [--cores N] [--calls N] [--no-warmup]\n"
+            << "                                STRUCTURE [STRUCTURE...]\n";
+}
+
+std::vector<std::string> split(const std::string& value) {
+  std::vector<std::string> entries;
+  std::size_t start = 0;
+  while (start <= value.size()) {
+    const auto end = std::min(value.find(',', start), value.size());
+    if (end > start) {
+      entries.push_back(value.substr(start, end - start));
+    }
+    start = end + 1;
+  }
+  return entries;
+}
+
+std::vector<int> splitInts(const std::string& value) {
+  std::vector<int> entries;
+  for (const auto& entry : split(value)) {
+    entries.push_back(std::stoi(entry));
+  }
+  return entries;
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+  using namespace Scine;
+  using namespace Scine::Xtb;
+  namespace Names = ThreadScalingBenchmarkSettingsNames;
+  std::vector<std::string> methods = {"GFN2"};
+  std::vector<std::string> structureFiles;
+  std::vector<int> workerCounts;
+  std::vector<int> threadsPerWorker;
+  int maxCores = 0;
+  int callsPerWorker = 0;
+  bool warmup = true;
+  try {
+    for (int i = 1; i < argc; ++i) {
+      const std::string option = argv[i];
+      if (option == "--help" || option == "-h") {
+        usage();
+        return 0;
+      }
+      if (option == "--no-warmup") {
+        warmup = false;
+        continue;
+      }
+      if (option.compare(0, 2, "--") != 0) {
+        structureFiles.push_back(option);
+        continue;
+      }
+      if (i + 1 >= argc) {
+        throw std::invalid_argument("The option " + option + " needs a value.");
+      }
+      const std::string value = argv[++i];
+      if (option == "--methods") {
+        methods = split(value);
+      }
+      else if (option == "--workers") {
+        workerCounts = splitInts(value);
+      }
+      else if (option == "--threads") {
+        threadsPerWorker = splitInts(value);
+      }
+      else if (option == "--cores") {
+        maxCores = std::stoi(value);
+      }
+      else if (option == "--calls") {
+        callsPerWorker = std::stoi(value);
+      }
+      else {
+        throw std::invalid_argument("Unknown option " + option + ".");
+      }
+    }
+    if (structureFiles.empty()) {
+      throw std::invalid_argument("At least one structure file is required.");
+    }
+  }
+  catch (const std::exception& e) {
+    std::cerr << e.what() << "\n";
+    usage();
+    return 1;
+  }
+
+  try {
+    std::vector<Utils::AtomCollection> structures;
+    for (const auto& file : structureFiles) {
+      structures.push_back(Utils::ChemicalFileHandler::read(file).first);
+    }
+    std::vector<std::shared_ptr<XtbCalculatorBase>> calculators;
+    for (const auto& method : methods) {
+      calculators.push_back(XtbCalculatorBase::create(method));
+    }
+    ThreadScalingBenchmark benchmark(std::move(calculators));
+    auto& settings = benchmark.settings();
+    // Empty lists and zero values keep the defaults of the benchmark
+    if (!workerCounts.empty()) {
+      settings.modifyIntList(Names::workerCounts, workerCounts);
+    }
+    if (!threadsPerWorker.empty()) {
+      settings.modifyIntList(Names::threadsPerWorker, threadsPerWorker);
+    }
+    if (maxCores > 0) {
+      settings.modifyInt(Names::maxCores, maxCores);
+    }
+    if (callsPerWorker > 0) {
+      settings.modifyInt(Names::callsPerWorker, callsPerWorker);
+    }
+    settings.modifyBool(Names::warmup, warmup);
+    const auto entries = benchmark.run(structures);
+    ThreadScalingBenchmark::writeTable(entries, std::cout);
+  }
+  catch (const std::exception& e) {
+    std::cerr << "The benchmark failed: " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -1,5 +1,44 @@
 cmake_minimum_required(VERSION 3.9)
 set(XTB_MODULE_FILES
+  "Xtb/Benchmark/ConcurrencyStress.cpp"
+  "Xtb/Benchmark/ConcurrencyStress.h"
+  "Xtb/Benchmark/ConcurrencyStressSettings.cpp"
+  "Xtb/Benchmark/ConcurrencyStressSettings.h"
+  "Xtb/Benchmark/StartupBenchmark.cpp"
+  "Xtb/Benchmark/StartupBenchmark.h"
+  "Xtb/Benchmark/StartupBenchmarkSettings.cpp"
+  "Xtb/Benchmark/StartupBenchmarkSettings.h"
+  "Xtb/Benchmark/ThreadScalingBenchmark.cpp"
+  "Xtb/Benchmark/ThreadScalingBenchmark.h"
+  "Xtb/Benchmark/ThreadScalingBenchmarkSettings.cpp"
+  "Xtb/Benchmark/ThreadScalingBenchmarkSettings.h"
+  "Xtb/Dynamics/MolecularDynamics.cpp"
+  "Xtb/Dynamics/MolecularDynamics.h"
+  "Xtb/Dynamics/MolecularDynamicsSettings.cpp"
+  "Xtb/Dynamics/MolecularDynamicsSettings.h"
+  "Xtb/Fragments/ManyBodyExpansion.cpp"
+  "Xtb/Fragments/ManyBodyExpansion.h"
+  "Xtb/Fragments/ManyBodyExpansionSettings.cpp"
+  "Xtb/Fragments/ManyBodyExpansionSettings.h"
+  "Xtb/Hessian/SymmetryDetector.cpp"
+  "Xtb/Hessian/SymmetryDetector.h"
+  "Xtb/Multilevel/Oniom.cpp"
+  "Xtb/Multilevel/Oniom.h"
+  "Xtb/Multilevel/OniomSettings.cpp"
+  "Xtb/Multilevel/OniomSettings.h"
+  "Xtb/Optimization/GeometryOptimizer.cpp"
+  "Xtb/Optimization/GeometryOptimizer.h"
+  "Xtb/Optimization/GeometryOptimizerSettings.cpp"
+  "Xtb/Optimization/GeometryOptimizerSettings.h"
+  "Xtb/Screening/ScreeningPipeline.cpp"
+  "Xtb/Screening/ScreeningPipeline.h"
+  "Xtb/Screening/ScreeningPipelineSettings.cpp"
+  "Xtb/Screening/ScreeningPipelineSettings.h"
+  "Xtb/Trajectory/TrajectoryEvaluator.cpp"
+  "Xtb/Trajectory/TrajectoryEvaluator.h"
+  "Xtb/Trajectory/TrajectoryEvaluatorSettings.cpp"
+  "Xtb/Trajectory/TrajectoryEvaluatorSettings.h"
+  "Xtb/Wrapper/CancellationToken.h"
   "Xtb/Wrapper/GFN0Wrapper.cpp"
   "Xtb/Wrapper/GFN0Wrapper.h"
   "Xtb/Wrapper/GFN1Wrapper.cpp"
@@ -8,11 +47,35 @@ set(XTB_MODULE_FILES
   "Xtb/Wrapper/GFN2Wrapper.h"
   "Xtb/Wrapper/GFNFFWrapper.cpp"
   "Xtb/Wrapper/GFNFFWrapper.h"
+  "Xtb/Wrapper/LockStatistics.h"
+  "Xtb/Wrapper/XtbCalculationInfo.h"
   "Xtb/Wrapper/XtbCalculatorBase.cpp"
   "Xtb/Wrapper/XtbCalculatorBase.h"
+  "Xtb/Wrapper/XtbExecutor.cpp"
+  "Xtb/Wrapper/XtbExecutor.h"
+  "Xtb/Wrapper/XtbOutputBuffers.h"
+  "Xtb/Wrapper/XtbRestartFile.cpp"
+  "Xtb/Wrapper/XtbRestartFile.h"
+  "Xtb/Wrapper/XtbSession.cpp"
+  "Xtb/Wrapper/XtbSession.h"
   "Xtb/Wrapper/XtbSettings.cpp"
   "Xtb/Wrapper/XtbSettings.h"
   "Xtb/Wrapper/XtbState.h"
   "Xtb/XtbModule.cpp"
   "Xtb/XtbModule.h"
 )
+# The calculation server and the process pool use POSIX sockets, fork and shared memory
+set(XTB_POSIX_FILES
+  "Xtb/ProcessPool/ProcessPool.cpp"
+  "Xtb/ProcessPool/ProcessPool.h"
+  "Xtb/ProcessPool/ProcessPoolSettings.cpp"
+  "Xtb/ProcessPool/ProcessPoolSettings.h"
+  "Xtb/Server/CalculationClient.cpp"
+  "Xtb/Server/CalculationClient.h"
+  "Xtb/Server/CalculationServer.cpp"
+  "Xtb/Server/CalculationServer.h"
+  "Xtb/Server/CalculationServerSettings.cpp"
+  "Xtb/Server/CalculationServerSettings.h"
+  "Xtb/Server/ServerProtocol.cpp"
+  "Xtb/Server/ServerProtocol.h"
+)
@@ -5,11 +5,11 @@ See LICENSE.txt for details.
 
 import os
 import scine_utilities as utils
-from distutils import ccompiler
 
 manager = utils.core.ModuleManager.get_instance()
 if not manager.module_loaded('Xtb'):
-    shlib_suffix = ccompiler.new_compiler().shared_lib_extension
+    # The shared library extension distutils reports, without importing it
+    shlib_suffix = ".dll" if os.name == "nt" else ".so"
     module_filename = "xtb.module" + shlib_suffix
     # Look within the python module directory (module is here in the case of
     # python packages) and the lib folder the site packages are in
@@ -0,0 +1,239 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Benchmark/ConcurrencyStress.h"
+#include "Xtb/Wrapper/XtbCalculatorBase.h"
+/* External Includes */
+#include <Utils/UniversalSettings/SettingsNames.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace Scine {
+namespace Xtb {
+
+ConcurrencyStress::ConcurrencyStress(std::vector<std::shared_ptr<XtbCalculatorBase>> calculators)
+  : _calculators(std::move(calculators)) {
+  if (_calculators.empty()) {
+    throw std::invalid_argument("The concurrency stress run needs at least one calculator.");
+  }
+}
+
+Utils::Settings& ConcurrencyStress::settings() {
+  return _settings;
+}
+
+const Utils::Settings& ConcurrencyStress::settings() const {
+  return _settings;
+}
+
+ConcurrencyStress::Result ConcurrencyStress::run(const std::vector<Utils::AtomCollection>& structures) {
+  namespace Names = ConcurrencyStressSettingsNames;
+  if (!_settings.valid()) {
+    _settings.throwIncorrectSettings();
+  }
+  Result result;
+  auto cases = _cases(structures);
+  result.nCases = cases.size();
+
+  // Serial reference
+  auto start = std::chrono::steady_clock::now();
+  std::vector<Case> references;
+  for (auto& c : cases) {
+    try {
+      c.reference = c.calculator->calculate("");
+      references.push_back(std::move(c));
+    }
+    catch (const std::exception& e) {
+      const std::string message = std::string("reference failed: ") + e.what();
+      result.mismatches.push_back({c.calculator->method(), c.variant, c.structure, message});
+    }
+  }
+  result.serialTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  if (references.empty()) {
+    return result;
+  }
+  result.serialCallsPerSecond = references.size() / result.serialTime;
+
+  // Concurrent repetitions, all threads start at once to maximize the contention
+  const int nThreads = _settings.getInt(Names::numberOfThreads);
+  const int calculatorsPerThread = _settings.getInt(Names::calculatorsPerThread);
+  const int repetitions = _settings.getInt(Names::repetitions);
+  std::mutex resultMutex;
+  std::atomic<bool> go{false};
+  std::atomic<int> ready{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < nThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      std::vector<std::pair<const Case*, std::shared_ptr<XtbCalculatorBase>>> own;
+      for (int m = 0; m < calculatorsPerThread; ++m) {
+        const auto& c = references[(t * calculatorsPerThread + m) % references.size()];
+        own.emplace_back(&c, c.calculator->clone());
+      }
+      ++ready;
+      while (!go.load()) {
+        std::this_thread::yield();
+      }
+      int nCalls = 0;
+      int nFailed = 0;
+      std::vector<Mismatch> mismatches;
+      for (int r = 0; r < repetitions; ++r) {
+        for (auto& calculator : own) {
+          const Case& c = *calculator.first;
+          std::string message;
+          ++nCalls;
+          try {
+            message = _compare(calculator.second->calculate(""), c.reference);
+          }
+          catch (const std::exception& e) {
+            ++nFailed;
+            message = std::string("calculation failed: ") + e.what();
+          }
+          if (!message.empty()) {
+            mismatches.push_back({c.calculator->method(), c.variant, c.structure, message});
+          }
+        }
+      }
+      std::lock_guard<std::mutex> lock(resultMutex);
+      result.nCalls += nCalls;
+      result.nFailed += nFailed;
+      result.mismatches.insert(result.mismatches.end(), mismatches.begin(), mismatches.end());
+    });
+  }
+  while (ready.load() < nThreads) {
+    std::this_thread::yield();
+  }
+  const auto lockingBefore = LockStatistics::methodLoading().snapshot();
+  start = std::chrono::steady_clock::now();
+  go.store(true);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  result.concurrentTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  result.concurrentCallsPerSecond = result.nCalls / result.concurrentTime;
+  const auto lockingAfter = LockStatistics::methodLoading().snapshot();
+  result.locking.acquisitions = lockingAfter.acquisitions - lockingBefore.acquisitions;
+  result.locking.contentions = lockingAfter.contentions - lockingBefore.contentions;
+  result.locking.waitTime = lockingAfter.waitTime - lockingBefore.waitTime;
+  return result;
+}
+
+void ConcurrencyStress::report(const Result& result, std::ostream& out) {
+  out << "Cases:                 " << result.nCases << "\n";
+  out << "Concurrent calls:      " << result.nCalls << " (" << result.nFailed << " failed)\n";
+  out << std::fixed << std::setprecision(2);
+  out << "Serial throughput:     " << result.serialCallsPerSecond << " calls/s\n";
+  out << "Concurrent throughput: " << result.concurrentCallsPerSecond << " calls/s\n";
+  out << "Method loading lock:   " << result.locking.acquisitions << " acquisitions, " << result.locking.contentions
+      << " contended, " << std::setprecision(4) << result.locking.waitTime << " s waiting\n";
+  out << "Mismatches:            " << result.mismatches.size() << "\n";
+  for (const auto& mismatch : result.mismatches) {
+    out << "  " << mismatch.method << " / " << mismatch.variant << " / structure " << mismatch.structure << ": "
+        << mismatch.message << "\n";
+  }
+  out << (result.passed() ? "PASSED" : "FAILED") << std::endl;
+}
+
+std::vector<ConcurrencyStress::Case>
+ConcurrencyStress::_cases(const std::vector<Utils::AtomCollection>& structures) const {
+  const int hessianMaxAtoms = _settings.getInt(ConcurrencyStressSettingsNames::hessianMaxAtoms);
+  std::vector<Case> cases;
+  auto add = [&](const XtbCalculatorBase& calculator, const std::string& variant, int structure,
+                 Utils::PropertyList properties) {
+    Case c;
+    c.calculator = calculator.clone();
+    auto& settings = c.calculator->settings();
+    settings.modifyInt(Utils::SettingsNames::externalProgramNProcs, 1);
+    // Every call has to run a full calculation
+    settings.modifyString(XtbSettingsNames::restartDirectory, "");
+    settings.modifyString(XtbSettingsNames::hessianUpdate, "none");
+    settings.modifyDouble(XtbSettingsNames::timeLimit, 0.0);
+    c.calculator->setStructure(structures[structure]);
+    c.calculator->setRequiredProperties(properties);
+    c.variant = variant;
+    c.structure = structure;
+    cases.push_back(std::move(c));
+    return cases.back().calculator;
+  };
+  for (const auto& calculator : _calculators) {
+    const auto solvents = calculator->availableSolvents();
+    const bool pointCharges = calculator->possibleProperties().containsSubSet(Utils::Property::PointChargesGradients);
+    for (int s = 0; s < static_cast<int>(structures.size()); ++s) {
+      const auto& structure = structures[s];
+      const Utils::PropertyList energyAndGradients = Utils::Property::Energy | Utils::Property::Gradients;
+      add(*calculator, "plain", s, energyAndGradients);
+      if (!solvents.empty()) {
+        const bool water = std::find(solvents.begin(), solvents.end(), "water") != solvents.end();
+        auto solvated = add(*calculator, "solvation", s, energyAndGradients);
+        solvated->settings().modifyString(Utils::SettingsNames::solvation, "gbsa");
+        solvated->settings().modifyString(Utils::SettingsNames::solvent, water ? "water" : solvents.front());
+      }
+      if (pointCharges) {
+        // A single point charge of +-0.5 outside of the molecule
+        const auto& positions = structure.getPositions();
+        const Utils::Position center = positions.colwise().mean();
+        const double extent = (positions.rowwise() - center).rowwise().norm().maxCoeff();
+        const Utils::Position charge = center + Utils::Position(extent + 6.0, 0.0, 0.0);
+        auto embedded = add(*calculator, "external_charges", s,
+                            energyAndGradients | Utils::Property::PointChargesGradients);
+        embedded->settings().modifyDoubleList(Utils::SettingsNames::mmCharges,
+                                              {s % 2 == 0 ? 0.5 : -0.5, 8.0, charge.x(), charge.y(), charge.z()});
+      }
+      if (structure.size() <= hessianMaxAtoms) {
+        add(*calculator, "hessian", s, energyAndGradients | Utils::Property::Hessian);
+      }
+    }
+  }
+  return cases;
+}
+
+std::string ConcurrencyStress::_compare(const Utils::Results& results, const Utils::Results& reference) const {
+  namespace Names = ConcurrencyStressSettingsNames;
+  std::ostringstream message;
+  message << std::scientific << std::setprecision(3);
+  const double energy = std::abs(results.get<Utils::Property::Energy>() - reference.get<Utils::Property::Energy>());
+  if (energy > _settings.getDouble(Names::energyTolerance)) {
+    message << "energy deviates by " << energy;
+    return message.str();
+  }
+  if (reference.has<Utils::Property::Gradients>()) {
+    const double gradients =
+        (results.get<Utils::Property::Gradients>() - reference.get<Utils::Property::Gradients>()).cwiseAbs().maxCoeff();
+    if (gradients > _settings.getDouble(Names::gradientTolerance)) {
+      message << "gradients deviate by " << gradients;
+      return message.str();
+    }
+  }
+  if (reference.has<Utils::Property::PointChargesGradients>()) {
+    const double gradients = (results.get<Utils::Property::PointChargesGradients>() -
+                              reference.get<Utils::Property::PointChargesGradients>())
+                                 .cwiseAbs()
+                                 .maxCoeff();
+    if (gradients > _settings.getDouble(Names::gradientTolerance)) {
+      message << "point charge gradients deviate by " << gradients;
+      return message.str();
+    }
+  }
+  if (reference.has<Utils::Property::Hessian>()) {
+    const double hessian =
+        (results.get<Utils::Property::Hessian>() - reference.get<Utils::Property::Hessian>()).cwiseAbs().maxCoeff();
+    if (hessian > _settings.getDouble(Names::hessianTolerance)) {
+      message << "Hessian deviates by " << hessian;
+      return message.str();
+    }
+  }
+  return "";
+}
+
+} /* namespace Xtb */
+} /* namespace Scine */
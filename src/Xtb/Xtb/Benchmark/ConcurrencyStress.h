@@ -0,0 +1,104 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_CONCURRENCYSTRESS_H_
+#define XTB_CONCURRENCYSTRESS_H_
+
+/* Internal Includes */
+#include "Xtb/Benchmark/ConcurrencyStressSettings.h"
+#include "Xtb/Wrapper/LockStatistics.h"
+/* External Includes */
+#include <Utils/CalculatorBasics.h>
+#include <Utils/Geometry/AtomCollection.h>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Scine {
+namespace Xtb {
+
+class XtbCalculatorBase;
+
+/**
+ * @class ConcurrencyStress
+ * @brief Stress run of many concurrent calculate() calls, checked against
+ *        serial reference values.
+ *
+ * Each given calculator is combined with each structure and with the setting
+ * variants it supports: plain, implicit solvation, external point charges and
+ * a Hessian for small structures. All cases are first calculated serially.
+ * Then a number of threads, each alternating between several clones of the
+ * cases, repeat the calculations concurrently, and every result is compared
+ * with its serial reference. Deviations point to races on global state, e.g.
+ * within the Fortran library, and the throughput and the contention of the
+ * parameter loading mutex quantify the cost of the serialization.
+ */
+class ConcurrencyStress {
+ public:
+  /// @brief A concurrent result deviating from its reference, or a failed calculation.
+  struct Mismatch {
+    std::string method;
+    std::string variant;
+    int structure = 0;
+    std::string message;
+  };
+  /// @brief The outcome of the stress run.
+  struct Result {
+    int nCases = 0;
+    int nCalls = 0;
+    int nFailed = 0;
+    /// @brief The wall-clock time of the serial reference and of the concurrent phase in seconds.
+    double serialTime = 0.0;
+    double concurrentTime = 0.0;
+    double serialCallsPerSecond = 0.0;
+    double concurrentCallsPerSecond = 0.0;
+    /// @brief The parameter loading mutex during the concurrent phase.
+    LockStatistics::Snapshot locking;
+    std::vector<Mismatch> mismatches;
+    /// @brief Whether all concurrent results match their references.
+    bool passed() const {
+      return mismatches.empty();
+    }
+  };
+  /**
+   * @brief Constructor.
+   * @param calculators The calculators of the methods to be covered, e.g. one
+   *                    of each GFN0, GFN1, GFN2 and GFN-FF.
+   */
+  explicit ConcurrencyStress(std::vector<std::shared_ptr<XtbCalculatorBase>> calculators);
+  /// @brief Accessor for the settings of the stress run.
+  Utils::Settings& settings();
+  /// @brief Const accessor for the settings of the stress run.
+  const Utils::Settings& settings() const;
+  /**
+   * @brief Runs the serial reference and the concurrent calculations.
+   * @param structures The structures, small molecules keep the run short.
+   * @return Result The throughput, the lock contention and all deviations.
+   */
+  Result run(const std::vector<Utils::AtomCollection>& structures);
+  /// @brief Writes a human-readable report of a stress run.
+  static void report(const Result& result, std::ostream& out);
+
+ private:
+  struct Case {
+    std::shared_ptr<XtbCalculatorBase> calculator;
+    std::string variant;
+    int structure = 0;
+    Utils::Results reference;
+  };
+  std::vector<Case> _cases(const std::vector<Utils::AtomCollection>& structures) const;
+  // An empty string if the results match the reference
+  std::string _compare(const Utils::Results& results, const Utils::Results& reference) const;
+
+  std::vector<std::shared_ptr<XtbCalculatorBase>> _calculators;
+  ConcurrencyStressSettings _settings;
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_CONCURRENCYSTRESS_H_ */
@@ -0,0 +1,66 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Benchmark/ConcurrencyStressSettings.h"
+/* External Includes */
+#include <algorithm>
+#include <thread>
+
+namespace Scine {
+namespace Xtb {
+
+ConcurrencyStressSettings::ConcurrencyStressSettings() : Scine::Utils::Settings("ConcurrencyStressSettings") {
+  using namespace Scine::Utils::UniversalSettings;
+  namespace Names = ConcurrencyStressSettingsNames;
+
+  // Load
+  IntDescriptor numberOfThreads("The number of threads calling calculate() concurrently.");
+  numberOfThreads.setMinimum(1);
+  numberOfThreads.setDefaultValue(std::max(2, static_cast<int>(std::thread::hardware_concurrency())));
+  this->_fields.push_back(Names::numberOfThreads, numberOfThreads);
+
+  IntDescriptor calculatorsPerThread("The number of calculators each thread alternates between. They are assigned "
+                                     "round-robin over all methods, setting variants and structures.");
+  calculatorsPerThread.setMinimum(1);
+  calculatorsPerThread.setDefaultValue(4);
+  this->_fields.push_back(Names::calculatorsPerThread, calculatorsPerThread);
+
+  IntDescriptor repetitions("The number of calculations of each calculator.");
+  repetitions.setMinimum(1);
+  repetitions.setDefaultValue(5);
+  this->_fields.push_back(Names::repetitions, repetitions);
+
+  IntDescriptor hessianMaxAtoms("The maximum number of atoms of a structure for which the Hessian variant is run, "
+                                "0 to skip Hessians.");
+  hessianMaxAtoms.setMinimum(0);
+  hessianMaxAtoms.setDefaultValue(12);
+  this->_fields.push_back(Names::hessianMaxAtoms, hessianMaxAtoms);
+
+  // Comparison with the serial reference
+  DoubleDescriptor energyTolerance("The maximum deviation of the energy from the serial reference in hartree.");
+  energyTolerance.setMinimum(0.0);
+  energyTolerance.setDefaultValue(1e-8);
+  this->_fields.push_back(Names::energyTolerance, energyTolerance);
+
+  DoubleDescriptor gradientTolerance("The maximum deviation of a gradient component from the serial reference in "
+                                     "hartree/bohr.");
+  gradientTolerance.setMinimum(0.0);
+  gradientTolerance.setDefaultValue(1e-6);
+  this->_fields.push_back(Names::gradientTolerance, gradientTolerance);
+
+  DoubleDescriptor hessianTolerance("The maximum deviation of a Hessian element from the serial reference in "
+                                    "hartree/bohr^2.");
+  hessianTolerance.setMinimum(0.0);
+  hessianTolerance.setDefaultValue(1e-5);
+  this->_fields.push_back(Names::hessianTolerance, hessianTolerance);
+
+  this->resetToDefaults();
+}
+
+} /* namespace Xtb */
+} /* namespace Scine */
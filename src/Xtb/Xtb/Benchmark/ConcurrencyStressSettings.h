@@ -0,0 +1,41 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_CONCURRENCYSTRESSSETTINGS_H_
+#define XTB_CONCURRENCYSTRESSSETTINGS_H_
+
+/* External Includes */
+#include <Utils/Settings.h>
+
+namespace Scine {
+namespace Xtb {
+
+namespace ConcurrencyStressSettingsNames {
+static constexpr const char* numberOfThreads = "number_of_threads";
+static constexpr const char* calculatorsPerThread = "calculators_per_thread";
+static constexpr const char* repetitions = "repetitions";
+static constexpr const char* hessianMaxAtoms = "hessian_max_atoms";
+static constexpr const char* energyTolerance = "energy_tolerance";
+static constexpr const char* gradientTolerance = "gradient_tolerance";
+static constexpr const char* hessianTolerance = "hessian_tolerance";
+} // namespace ConcurrencyStressSettingsNames
+
+/**
+ * @class ConcurrencyStressSettings
+ * @brief The settings of the concurrent throughput stress run.
+ */
+class ConcurrencyStressSettings : public Scine::Utils::Settings {
+ public:
+  /**
+   * @brief Construct a new ConcurrencyStressSettings object.
+   */
+  ConcurrencyStressSettings();
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_CONCURRENCYSTRESSSETTINGS_H_ */
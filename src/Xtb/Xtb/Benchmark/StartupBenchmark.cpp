@@ -0,0 +1,89 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Benchmark/StartupBenchmark.h"
+#include "Xtb/Wrapper/XtbCalculatorBase.h"
+/* External Includes */
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+
+namespace Scine {
+namespace Xtb {
+
+bool StartupBenchmark::Result::passed() const {
+  return std::all_of(entries.begin(), entries.end(), [&](const Entry& entry) {
+    return entry.construction <= constructionTarget && entry.firstResult <= firstResultTarget;
+  });
+}
+
+Utils::Settings& StartupBenchmark::settings() {
+  return _settings;
+}
+
+const Utils::Settings& StartupBenchmark::settings() const {
+  return _settings;
+}
+
+StartupBenchmark::Result StartupBenchmark::run(const Utils::AtomCollection& structure) {
+  namespace Names = StartupBenchmarkSettingsNames;
+  if (!_settings.valid()) {
+    _settings.throwIncorrectSettings();
+  }
+  using Clock = std::chrono::steady_clock;
+  const int constructions = _settings.getInt(Names::constructions);
+  Result result;
+  result.constructionTarget = _settings.getDouble(Names::constructionTarget);
+  result.firstResultTarget = _settings.getDouble(Names::firstResultTarget);
+  for (const auto& method : _settings.getStringList(Names::methods)) {
+    Entry entry;
+    entry.method = method;
+
+    auto start = Clock::now();
+    auto calculator = XtbCalculatorBase::create(method);
+    entry.firstConstruction = 1e6 * std::chrono::duration<double>(Clock::now() - start).count();
+    calculator->setStructure(structure);
+    calculator->calculate("");
+    entry.firstResult = std::chrono::duration<double>(Clock::now() - start).count();
+
+    start = Clock::now();
+    for (int n = 0; n < constructions; ++n) {
+      calculator = XtbCalculatorBase::create(method);
+    }
+    entry.construction = 1e6 * std::chrono::duration<double>(Clock::now() - start).count() / constructions;
+
+    start = Clock::now();
+    calculator = XtbCalculatorBase::create(method);
+    calculator->setStructure(structure);
+    calculator->calculate("");
+    entry.laterResult = std::chrono::duration<double>(Clock::now() - start).count();
+    result.entries.push_back(entry);
+  }
+  return result;
+}
+
+void StartupBenchmark::writeTable(const Result& result, std::ostream& out) {
+  const auto flags = out.flags();
+  const auto precision = out.precision();
+  out << std::left << std::setw(8) << "method" << std::right << std::setw(16) << "first ctor/us" << std::setw(14)
+      << "ctor/us" << std::setw(14) << "first/s" << std::setw(14) << "later/s"
+      << "\n";
+  for (const auto& e : result.entries) {
+    out << std::left << std::setw(8) << e.method << std::right << std::fixed << std::setprecision(2) << std::setw(16)
+        << e.firstConstruction << std::setw(14) << e.construction << std::setprecision(4) << std::setw(14)
+        << e.firstResult << std::setw(14) << e.laterResult << "\n";
+  }
+  out << std::setprecision(2) << "\nTargets: " << result.constructionTarget << " us per construction, "
+      << std::setprecision(4) << result.firstResultTarget << " s to the first result in this process\n";
+  out << (result.passed() ? "PASSED" : "FAILED") << std::endl;
+  out.flags(flags);
+  out.precision(precision);
+}
+
+} /* namespace Xtb */
+} /* namespace Scine */
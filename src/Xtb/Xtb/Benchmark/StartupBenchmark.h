@@ -0,0 +1,82 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_STARTUPBENCHMARK_H_
+#define XTB_STARTUPBENCHMARK_H_
+
+/* Internal Includes */
+#include "Xtb/Benchmark/StartupBenchmarkSettings.h"
+/* External Includes */
+#include <Utils/Geometry/AtomCollection.h>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Scine {
+namespace Xtb {
+
+class XtbCalculatorBase;
+
+/**
+ * @class StartupBenchmark
+ * @brief Measures what a short-lived worker process pays before its first
+ *        result.
+ *
+ * For each method, the first construction of a calculator and its first
+ * calculation are timed as the first result in this process. Afterwards, the
+ * mean time of constructing further calculators and of a calculation with a
+ * freshly constructed calculator is measured.
+ *
+ * All times are taken within the running process: the loading of the module
+ * is never included, and the one-time initialization of xtb shared between
+ * the methods is only paid by the first method of the run. The
+ * scine_xtb_startup_benchmark executable runs each method in a fresh process
+ * and also reports the wall time of the whole process.
+ */
+class StartupBenchmark {
+ public:
+  /// @brief The measurement of one method.
+  struct Entry {
+    std::string method;
+    /// @brief The time of the first construction in microseconds.
+    double firstConstruction = 0.0;
+    /// @brief The mean time of the subsequent constructions in microseconds.
+    double construction = 0.0;
+    /// @brief The time from the first construction of the method in this process to its first result in seconds.
+    double firstResult = 0.0;
+    /// @brief The time from a later construction to its first result in seconds.
+    double laterResult = 0.0;
+  };
+  /// @brief The outcome of the benchmark.
+  struct Result {
+    std::vector<Entry> entries;
+    double constructionTarget = 0.0;
+    double firstResultTarget = 0.0;
+    /// @brief Whether all methods meet both targets.
+    bool passed() const;
+  };
+  /// @brief Accessor for the settings of the benchmark.
+  Utils::Settings& settings();
+  /// @brief Const accessor for the settings of the benchmark.
+  const Utils::Settings& settings() const;
+  /**
+   * @brief Runs the benchmark.
+   * @param structure A small structure, the calculation time should not dominate.
+   * @return Result The timings of all methods.
+   */
+  Result run(const Utils::AtomCollection& structure);
+  /// @brief Writes the timings and whether the targets are met as an aligned table.
+  static void writeTable(const Result& result, std::ostream& out);
+
+ private:
+  StartupBenchmarkSettings _settings;
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_STARTUPBENCHMARK_H_ */
@@ -0,0 +1,43 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Benchmark/StartupBenchmarkSettings.h"
+
+namespace Scine {
+namespace Xtb {
+
+StartupBenchmarkSettings::StartupBenchmarkSettings() : Scine::Utils::Settings("StartupBenchmarkSettings") {
+  using namespace Scine::Utils::UniversalSettings;
+  namespace Names = StartupBenchmarkSettingsNames;
+
+  StringListDescriptor methods("The methods to be measured, any of GFN0, GFN1, GFN2 and GFNFF.");
+  methods.setDefaultValue({"GFN0", "GFN1", "GFN2", "GFNFF"});
+  this->_fields.push_back(Names::methods, methods);
+
+  IntDescriptor constructions("The number of timed calculator constructions per method.");
+  constructions.setMinimum(1);
+  constructions.setDefaultValue(1000);
+  this->_fields.push_back(Names::constructions, constructions);
+
+  // Targets
+  DoubleDescriptor constructionTarget("The maximum mean time of a calculator construction in microseconds.");
+  constructionTarget.setMinimum(0.0);
+  constructionTarget.setDefaultValue(100.0);
+  this->_fields.push_back(Names::constructionTarget, constructionTarget);
+
+  DoubleDescriptor firstResultTarget("The maximum time from the construction of the first calculator of a method "
+                                     "within the process to its first result in seconds.");
+  firstResultTarget.setMinimum(0.0);
+  firstResultTarget.setDefaultValue(1.0);
+  this->_fields.push_back(Names::firstResultTarget, firstResultTarget);
+
+  this->resetToDefaults();
+}
+
+} /* namespace Xtb */
+} /* namespace Scine */
@@ -0,0 +1,38 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_STARTUPBENCHMARKSETTINGS_H_
+#define XTB_STARTUPBENCHMARKSETTINGS_H_
+
+/* External Includes */
+#include <Utils/Settings.h>
+
+namespace Scine {
+namespace Xtb {
+
+namespace StartupBenchmarkSettingsNames {
+static constexpr const char* methods = "methods";
+static constexpr const char* constructions = "constructions";
+static constexpr const char* constructionTarget = "construction_target";
+static constexpr const char* firstResultTarget = "first_result_target";
+} // namespace StartupBenchmarkSettingsNames
+
+/**
+ * @class StartupBenchmarkSettings
+ * @brief The settings of the startup benchmark.
+ */
+class StartupBenchmarkSettings : public Scine::Utils::Settings {
+ public:
+  /**
+   * @brief Construct a new StartupBenchmarkSettings object.
+   */
+  StartupBenchmarkSettings();
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_STARTUPBENCHMARKSETTINGS_H_ */
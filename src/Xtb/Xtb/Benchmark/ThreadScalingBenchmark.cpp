@@ -0,0 +1,209 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Benchmark/ThreadScalingBenchmark.h"
+#include "Xtb/Wrapper/XtbCalculatorBase.h"
+/* External Includes */
+#include <Utils/UniversalSettings/SettingsNames.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <iomanip>
+#include <map>
+#include <numeric>
+#include <thread>
+
+namespace Scine {
+namespace Xtb {
+
+ThreadScalingBenchmark::ThreadScalingBenchmark(std::vector<std::shared_ptr<XtbCalculatorBase>> calculators)
+  : _calculators(std::move(calculators)) {
+  if (_calculators.empty()) {
+    throw std::invalid_argument("The thread scaling benchmark needs at least one calculator.");
+  }
+}
+
+Utils::Settings& ThreadScalingBenchmark::settings() {
+  return _settings;
+}
+
+const Utils::Settings& ThreadScalingBenchmark::settings() const {
+  return _settings;
+}
+
+std::vector<ThreadScalingBenchmark::Entry>
+ThreadScalingBenchmark::run(const std::vector<Utils::AtomCollection>& structures) {
+  namespace Names = ThreadScalingBenchmarkSettingsNames;
+  if (!_settings.valid()) {
+    _settings.throwIncorrectSettings();
+  }
+  const int maxCores = _settings.getInt(Names::maxCores);
+  const auto workerCounts = _sweep(Names::workerCounts);
+  const auto threadCounts = _sweep(Names::threadsPerWorker);
+  std::vector<Entry> entries;
+  for (const auto& calculator : _calculators) {
+    for (int s = 0; s < static_cast<int>(structures.size()); ++s) {
+      for (const int workers : workerCounts) {
+        for (const int threads : threadCounts) {
+          if (workers * threads > maxCores) {
+            continue;
+          }
+          Entry entry = _measure(*calculator, structures[s], workers, threads);
+          entry.structure = s;
+          entries.push_back(entry);
+        }
+      }
+    }
+  }
+  return entries;
+}
+
+std::vector<int> ThreadScalingBenchmark::_sweep(const char* key) const {
+  auto values = _settings.getIntList(key);
+  if (values.empty()) {
+    for (int n = 1; n <= _settings.getInt(ThreadScalingBenchmarkSettingsNames::maxCores); n *= 2) {
+      values.push_back(n);
+    }
+  }
+  if (std::any_of(values.begin(), values.end(), [](int n) { return n < 1; })) {
+    throw std::runtime_error(std::string("The ") + key + " of the thread scaling benchmark have to be positive.");
+  }
+  return values;
+}
+
+ThreadScalingBenchmark::Entry ThreadScalingBenchmark::_measure(const XtbCalculatorBase& calculator,
+                                                               const Utils::AtomCollection& structure, int workers,
+                                                               int threadsPerWorker) const {
+  namespace Names = ThreadScalingBenchmarkSettingsNames;
+  const int callsPerWorker = _settings.getInt(Names::callsPerWorker);
+  const bool warmup = _settings.getBool(Names::warmup);
+  std::vector<std::shared_ptr<XtbCalculatorBase>> clones;
+  for (int w = 0; w < workers; ++w) {
+    auto clone = calculator.clone();
+    clone->settings().modifyInt(Utils::SettingsNames::externalProgramNProcs, threadsPerWorker);
+    // Every call has to run a full calculation
+    clone->settings().modifyString(XtbSettingsNames::restartDirectory, "");
+    clone->setStructure(structure);
+    clones.push_back(std::move(clone));
+  }
+  if (warmup) {
+    for (auto& clone : clones) {
+      clone->calculate("");
+    }
+  }
+
+  std::vector<std::vector<double>> latencies(workers);
+  std::vector<std::exception_ptr> errors(workers);
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int w = 0; w < workers; ++w) {
+    threads.emplace_back([&, w]() {
+      try {
+        for (int n = 0; n < callsPerWorker; ++n) {
+          const auto callStart = std::chrono::steady_clock::now();
+          clones[w]->calculate("");
+          latencies[w].push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - callStart).count());
+        }
+      }
+      catch (...) {
+        errors[w] = std::current_exception();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const double wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  for (const auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  std::vector<double> all;
+  for (const auto& l : latencies) {
+    all.insert(all.end(), l.begin(), l.end());
+  }
+  std::sort(all.begin(), all.end());
+  Entry entry;
+  entry.method = calculator.method();
+  entry.nAtoms = structure.size();
+  entry.workers = workers;
+  entry.threadsPerWorker = threadsPerWorker;
+  entry.throughput = all.size() / wallTime;
+  entry.meanLatency = std::accumulate(all.begin(), all.end(), 0.0) / all.size();
+  // Nearest-rank percentile
+  entry.p95Latency = all[static_cast<std::size_t>(std::ceil(0.95 * all.size())) - 1];
+  entry.maxLatency = all.back();
+  return entry;
+}
+
+std::vector<ThreadScalingBenchmark::Recommendation>
+ThreadScalingBenchmark::recommend(const std::vector<Entry>& entries) {
+  std::vector<Recommendation> recommendations;
+  std::map<std::pair<std::string, int>, int> index;
+  for (const auto& entry : entries) {
+    const auto key = std::make_pair(entry.method, entry.structure);
+    auto it = index.find(key);
+    if (it == index.end()) {
+      index[key] = recommendations.size();
+      Recommendation recommendation;
+      recommendation.method = entry.method;
+      recommendation.structure = entry.structure;
+      recommendation.nAtoms = entry.nAtoms;
+      recommendation.bestThroughput = entry;
+      recommendation.bestLatency = entry;
+      recommendations.push_back(recommendation);
+      continue;
+    }
+    auto& recommendation = recommendations[it->second];
+    if (entry.throughput > recommendation.bestThroughput.throughput) {
+      recommendation.bestThroughput = entry;
+    }
+    if (entry.meanLatency < recommendation.bestLatency.meanLatency) {
+      recommendation.bestLatency = entry;
+    }
+  }
+  return recommendations;
+}
+
+void ThreadScalingBenchmark::writeTable(const std::vector<Entry>& entries, std::ostream& out) {
+  const auto flags = out.flags();
+  const auto precision = out.precision();
+  out << std::left << std::setw(8) << "method" << std::right << std::setw(10) << "structure" << std::setw(8)
+      << "atoms" << std::setw(9) << "workers" << std::setw(9) << "threads" << std::setw(14) << "calls/s"
+      << std::setw(12) << "mean/s" << std::setw(12) << "p95/s" << std::setw(12) << "max/s"
+      << "\n";
+  for (const auto& e : entries) {
+    out << std::left << std::setw(8) << e.method << std::right << std::setw(10) << e.structure << std::setw(8)
+        << e.nAtoms << std::setw(9) << e.workers << std::setw(9) << e.threadsPerWorker << std::fixed
+        << std::setprecision(2) << std::setw(14) << e.throughput << std::setprecision(4) << std::setw(12)
+        << e.meanLatency << std::setw(12) << e.p95Latency << std::setw(12) << e.maxLatency << "\n";
+  }
+  out << "\nRecommendations (workers x threads per worker)\n";
+  out << std::left << std::setw(8) << "method" << std::right << std::setw(10) << "structure" << std::setw(8)
+      << "atoms" << std::setw(16) << "throughput" << std::setw(14) << "calls/s" << std::setw(16) << "latency"
+      << std::setw(12) << "mean/s"
+      << "\n";
+  for (const auto& r : recommend(entries)) {
+    const std::string throughput =
+        std::to_string(r.bestThroughput.workers) + " x " + std::to_string(r.bestThroughput.threadsPerWorker);
+    const std::string latency =
+        std::to_string(r.bestLatency.workers) + " x " + std::to_string(r.bestLatency.threadsPerWorker);
+    out << std::left << std::setw(8) << r.method << std::right << std::setw(10) << r.structure << std::setw(8)
+        << r.nAtoms << std::setw(16) << throughput << std::fixed << std::setprecision(2) << std::setw(14)
+        << r.bestThroughput.throughput << std::setw(16) << latency << std::setprecision(4) << std::setw(12)
+        << r.bestLatency.meanLatency << "\n";
+  }
+  out.flags(flags);
+  out.precision(precision);
+}
+
+} /* namespace Xtb */
+} /* namespace Scine */
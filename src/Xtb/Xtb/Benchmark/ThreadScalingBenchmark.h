@@ -0,0 +1,94 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_THREADSCALINGBENCHMARK_H_
+#define XTB_THREADSCALINGBENCHMARK_H_
+
+/* Internal Includes */
+#include "Xtb/Benchmark/ThreadScalingBenchmarkSettings.h"
+/* External Includes */
+#include <Utils/Geometry/AtomCollection.h>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Scine {
+namespace Xtb {
+
+class XtbCalculatorBase;
+
+/**
+ * @class ThreadScalingBenchmark
+ * @brief Sweeps the number of concurrent calculators against the number of
+ *        OpenMP threads per calculator.
+ *
+ * For each method and structure, every combination of workers and threads per
+ * worker within the cores of the node is measured. Each worker is a thread
+ * owning a clone of the calculator with externalProgramNProcs set to the
+ * threads per worker. The throughput (calculations per second over all
+ * workers) and the latency of the single calculations are recorded. The
+ * recommendation is the combination with the highest throughput, and for
+ * latency-bound use the one with the lowest mean latency.
+ */
+class ThreadScalingBenchmark {
+ public:
+  /// @brief The measurement of one combination.
+  struct Entry {
+    std::string method;
+    int structure = 0;
+    int nAtoms = 0;
+    int workers = 0;
+    int threadsPerWorker = 0;
+    /// @brief Calculations per second over all workers.
+    double throughput = 0.0;
+    /// @brief The mean, 95th percentile and maximum latency of a calculation in seconds.
+    double meanLatency = 0.0;
+    double p95Latency = 0.0;
+    double maxLatency = 0.0;
+  };
+  /// @brief The best combinations for one method and structure.
+  struct Recommendation {
+    std::string method;
+    int structure = 0;
+    int nAtoms = 0;
+    Entry bestThroughput;
+    Entry bestLatency;
+  };
+  /**
+   * @brief Constructor.
+   * @param calculators The calculators of the methods to be benchmarked with
+   *                    their production settings and required properties.
+   */
+  explicit ThreadScalingBenchmark(std::vector<std::shared_ptr<XtbCalculatorBase>> calculators);
+  /// @brief Accessor for the settings of the benchmark.
+  Utils::Settings& settings();
+  /// @brief Const accessor for the settings of the benchmark.
+  const Utils::Settings& settings() const;
+  /**
+   * @brief Runs the sweep.
+   * @param structures Representative structures of the production systems.
+   * @return std::vector<Entry> One entry per method, structure and combination.
+   */
+  std::vector<Entry> run(const std::vector<Utils::AtomCollection>& structures);
+  /// @brief The best combinations per method and structure.
+  static std::vector<Recommendation> recommend(const std::vector<Entry>& entries);
+  /// @brief Writes all measurements and the recommendations as aligned tables.
+  static void writeTable(const std::vector<Entry>& entries, std::ostream& out);
+
+ private:
+  Entry _measure(const XtbCalculatorBase& calculator, const Utils::AtomCollection& structure, int workers,
+                 int threadsPerWorker) const;
+  std::vector<int> _sweep(const char* key) const;
+
+  std::vector<std::shared_ptr<XtbCalculatorBase>> _calculators;
+  ThreadScalingBenchmarkSettings _settings;
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_THREADSCALINGBENCHMARK_H_ */
@@ -0,0 +1,52 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Benchmark/ThreadScalingBenchmarkSettings.h"
+/* External Includes */
+#include <algorithm>
+#include <thread>
+
+namespace Scine {
+namespace Xtb {
+
+ThreadScalingBenchmarkSettings::ThreadScalingBenchmarkSettings()
+  : Scine::Utils::Settings("ThreadScalingBenchmarkSettings") {
+  using namespace Scine::Utils::UniversalSettings;
+  namespace Names = ThreadScalingBenchmarkSettingsNames;
+
+  // Sweep
+  IntListDescriptor workerCounts("The numbers of concurrent calculators to be tested. If empty, the powers of two "
+                                 "up to max_cores are tested.");
+  this->_fields.push_back(Names::workerCounts, workerCounts);
+
+  IntListDescriptor threadsPerWorker("The numbers of OpenMP threads per calculator (externalProgramNProcs) to be "
+                                     "tested. If empty, the powers of two up to max_cores are tested.");
+  this->_fields.push_back(Names::threadsPerWorker, threadsPerWorker);
+
+  IntDescriptor maxCores("The number of cores of the node. Combinations with more workers times threads per worker "
+                         "are skipped.");
+  maxCores.setMinimum(1);
+  maxCores.setDefaultValue(std::max(1, static_cast<int>(std::thread::hardware_concurrency())));
+  this->_fields.push_back(Names::maxCores, maxCores);
+
+  // Measurement
+  IntDescriptor callsPerWorker("The number of timed calculations of each worker per combination.");
+  callsPerWorker.setMinimum(1);
+  callsPerWorker.setDefaultValue(4);
+  this->_fields.push_back(Names::callsPerWorker, callsPerWorker);
+
+  BoolDescriptor warmup("Whether each worker runs one untimed calculation first, which excludes the loading of the "
+                        "parametrization from the measurement.");
+  warmup.setDefaultValue(true);
+  this->_fields.push_back(Names::warmup, warmup);
+
+  this->resetToDefaults();
+}
+
+} /* namespace Xtb */
+} /* namespace Scine */
@@ -0,0 +1,39 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_THREADSCALINGBENCHMARKSETTINGS_H_
+#define XTB_THREADSCALINGBENCHMARKSETTINGS_H_
+
+/* External Includes */
+#include <Utils/Settings.h>
+
+namespace Scine {
+namespace Xtb {
+
+namespace ThreadScalingBenchmarkSettingsNames {
+static constexpr const char* workerCounts = "worker_counts";
+static constexpr const char* threadsPerWorker = "threads_per_worker";
+static constexpr const char* maxCores = "max_cores";
+static constexpr const char* callsPerWorker = "calls_per_worker";
+static constexpr const char* warmup = "warmup";
+} // namespace ThreadScalingBenchmarkSettingsNames
+
+/**
+ * @class ThreadScalingBenchmarkSettings
+ * @brief The settings of the thread scaling benchmark.
+ */
+class ThreadScalingBenchmarkSettings : public Scine::Utils::Settings {
+ public:
+  /**
+   * @brief Construct a new ThreadScalingBenchmarkSettings object.
+   */
+  ThreadScalingBenchmarkSettings();
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_THREADSCALINGBENCHMARKSETTINGS_H_ */
@@ -0,0 +1,276 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Dynamics/MolecularDynamics.h"
+#include "Xtb/Wrapper/XtbCalculatorBase.h"
+#include "Xtb/Wrapper/XtbSession.h"
+/* External Includes */
+#include <Utils/Bonds/BondDetector.h>
+#include <Utils/Bonds/BondOrderCollection.h>
+#include <Utils/Geometry/ElementInfo.h>
+#include <cmath>
+
+namespace Scine {
+namespace Xtb {
+
+namespace {
+// Boltzmann constant in hartree per Kelvin
+constexpr double boltzmannConstant = 3.166811563e-6;
+// Atomic mass unit in electron masses
+constexpr double electronMassesPerDalton = 1822.888486209;
+// Femtoseconds per atomic unit of time
+constexpr double femtosecondsPerAtomicTime = 0.02418884326585747;
+constexpr int maxConstraintIterations = 500;
+} // namespace
+
+MolecularDynamics::MolecularDynamics(XtbCalculatorBase& calculator) : _calculator(calculator) {
+}
+
+Utils::Settings& MolecularDynamics::settings() {
+  return _settings;
+}
+
+const Utils::Settings& MolecularDynamics::settings() const {
+  return _settings;
+}
+
+void MolecularDynamics::setFrameSink(FrameSink sink) {
+  _sink = std::move(sink);
+}
+
+void MolecularDynamics::setInitialVelocities(Utils::DisplacementCollection velocities) {
+  _initialVelocities = std::move(velocities);
+}
+
+void MolecularDynamics::performMD(const Utils::AtomCollection& structure) {
+  namespace Names = MolecularDynamicsSettingsNames;
+  if (!_settings.valid()) {
+    _settings.throwIncorrectSettings();
+  }
+  const int nAtoms = structure.size();
+  if (nAtoms == 0) {
+    throw std::runtime_error("Molecular dynamics requires a non-empty structure.");
+  }
+  if (_initialVelocities.size() != 0 && _initialVelocities.rows() != nAtoms) {
+    throw std::runtime_error("The number of initial velocities does not match the number of atoms.");
+  }
+  const double timeStep = _settings.getDouble(Names::timeStep) / femtosecondsPerAtomicTime;
+  const int nSteps = _settings.getInt(Names::numberOfSteps);
+  const int recordFrequency = _settings.getInt(Names::recordFrequency);
+  const std::string thermostat = _settings.getString(Names::thermostat);
+  const double targetTemperature = _settings.getDouble(Names::targetTemperature);
+  const double couplingTime = _settings.getDouble(Names::couplingTime) / femtosecondsPerAtomicTime;
+  std::mt19937 generator(static_cast<unsigned>(_settings.getInt(Names::seed)));
+  std::normal_distribution<double> normal(0.0, 1.0);
+
+  _masses.resize(nAtoms);
+  for (int i = 0; i < nAtoms; ++i) {
+    _masses[i] = Utils::ElementInfo::mass(structure.getElement(i)) * electronMassesPerDalton;
+  }
+  _positions = structure.getPositions();
+  _constraints.clear();
+  if (_settings.getBool(Names::constrainHydrogenBonds)) {
+    _detectConstraints(structure);
+  }
+  _initializeVelocities(generator);
+
+  // One session for the whole trajectory
+  _calculator.setStructure(structure);
+  auto session = _calculator.createSession();
+  _evaluate(*session);
+  _record(0, 0.0);
+
+  const double frictionFactor = (couplingTime > 0.0) ? std::exp(-timeStep / couplingTime) : 0.0;
+  for (int step = 1; step <= nSteps; ++step) {
+    // Velocity Verlet: half kick, drift, force evaluation, half kick
+    _velocities -= 0.5 * timeStep * (_masses.cwiseInverse().asDiagonal() * _gradients);
+    const Utils::PositionCollection oldPositions = _positions;
+    _positions += timeStep * _velocities;
+    _shake(oldPositions, timeStep);
+    session->updatePositions(_positions);
+    _evaluate(*session);
+    _velocities -= 0.5 * timeStep * (_masses.cwiseInverse().asDiagonal() * _gradients);
+    _rattle();
+
+    // Thermostat
+    if (thermostat == "berendsen") {
+      const double temperature = _temperature(_kineticEnergy());
+      if (temperature > 0.0 && couplingTime > 0.0) {
+        const double lambda2 = 1.0 + timeStep / couplingTime * (targetTemperature / temperature - 1.0);
+        _velocities *= std::sqrt(std::max(lambda2, 0.0));
+      }
+    }
+    else if (thermostat == "langevin") {
+      const double noise = std::sqrt(1.0 - frictionFactor * frictionFactor);
+      for (int i = 0; i < nAtoms; ++i) {
+        const double sigma = std::sqrt(boltzmannConstant * targetTemperature / _masses[i]);
+        for (int j = 0; j < 3; ++j) {
+          _velocities(i, j) = frictionFactor * _velocities(i, j) + noise * sigma * normal(generator);
+        }
+      }
+      _rattle();
+    }
+
+    if (step % recordFrequency == 0) {
+      _record(step, step * timeStep * femtosecondsPerAtomicTime);
+    }
+  }
+  _initialVelocities.resize(0, 3);
+  _calculator.modifyPositions(_positions);
+}
+
+const Utils::PositionCollection& MolecularDynamics::getPositions() const {
+  return _positions;
+}
+
+const Utils::DisplacementCollection& MolecularDynamics::getVelocities() const {
+  return _velocities;
+}
+
+double MolecularDynamics::getPotentialEnergy() const {
+  return _potentialEnergy;
+}
+
+void MolecularDynamics::_evaluate(XtbSession& session) {
+  session.singlepoint();
+  _potentialEnergy = session.getEnergy();
+  // Written in place, the gradients keep their storage over all steps
+  _gradients.resize(_positions.rows(), 3);
+  session.getGradients(_gradients.data());
+}
+
+void MolecularDynamics::_initializeVelocities(std::mt19937& generator) {
+  const int nAtoms = _positions.rows();
+  if (_initialVelocities.rows() == nAtoms) {
+    _velocities = _initialVelocities;
+    _rattle();
+    return;
+  }
+  const double temperature = _settings.getDouble(MolecularDynamicsSettingsNames::initialTemperature);
+  _velocities = Utils::DisplacementCollection::Zero(nAtoms, 3);
+  if (temperature <= 0.0 || nAtoms == 1) {
+    return;
+  }
+  std::normal_distribution<double> normal(0.0, 1.0);
+  for (int i = 0; i < nAtoms; ++i) {
+    const double sigma = std::sqrt(boltzmannConstant * temperature / _masses[i]);
+    for (int j = 0; j < 3; ++j) {
+      _velocities(i, j) = sigma * normal(generator);
+    }
+  }
+  // Remove the center of mass motion
+  const Eigen::RowVector3d momentum = _masses.transpose() * _velocities;
+  _velocities.rowwise() -= momentum / _masses.sum();
+  _rattle();
+  // Scale to the exact initial temperature
+  const double current = _temperature(_kineticEnergy());
+  if (current > 0.0) {
+    _velocities *= std::sqrt(temperature / current);
+  }
+}
+
+void MolecularDynamics::_detectConstraints(const Utils::AtomCollection& structure) {
+  const auto bondOrders = Utils::BondDetector::detectBonds(structure);
+  const auto& matrix = bondOrders.getMatrix();
+  for (int k = 0; k < matrix.outerSize(); ++k) {
+    for (Eigen::SparseMatrix<double>::InnerIterator it(matrix, k); it; ++it) {
+      const int i = static_cast<int>(it.row());
+      const int j = static_cast<int>(it.col());
+      if (i >= j || it.value() < 0.5) {
+        continue;
+      }
+      if (structure.getElement(i) == Utils::ElementType::H || structure.getElement(j) == Utils::ElementType::H) {
+        _constraints.emplace_back(i, j, (_positions.row(i) - _positions.row(j)).squaredNorm());
+      }
+    }
+  }
+}
+
+void MolecularDynamics::_shake(const Utils::PositionCollection& oldPositions, double timeStep) {
+  if (_constraints.empty()) {
+    return;
+  }
+  const double tolerance = _settings.getDouble(MolecularDynamicsSettingsNames::constraintTolerance);
+  for (int iteration = 0; iteration < maxConstraintIterations; ++iteration) {
+    bool converged = true;
+    for (const auto& constraint : _constraints) {
+      const int i = std::get<0>(constraint);
+      const int j = std::get<1>(constraint);
+      const double d2 = std::get<2>(constraint);
+      const Eigen::RowVector3d r = _positions.row(i) - _positions.row(j);
+      const double diff = d2 - r.squaredNorm();
+      if (std::abs(diff) <= 2.0 * tolerance * d2) {
+        continue;
+      }
+      converged = false;
+      const Eigen::RowVector3d rOld = oldPositions.row(i) - oldPositions.row(j);
+      const double g = diff / (2.0 * (1.0 / _masses[i] + 1.0 / _masses[j]) * r.dot(rOld));
+      _positions.row(i) += g / _masses[i] * rOld;
+      _positions.row(j) -= g / _masses[j] * rOld;
+      _velocities.row(i) += g / (_masses[i] * timeStep) * rOld;
+      _velocities.row(j) -= g / (_masses[j] * timeStep) * rOld;
+    }
+    if (converged) {
+      return;
+    }
+  }
+  throw std::runtime_error("SHAKE did not converge.");
+}
+
+void MolecularDynamics::_rattle() {
+  if (_constraints.empty()) {
+    return;
+  }
+  const double tolerance = _settings.getDouble(MolecularDynamicsSettingsNames::constraintTolerance);
+  for (int iteration = 0; iteration < maxConstraintIterations; ++iteration) {
+    bool converged = true;
+    for (const auto& constraint : _constraints) {
+      const int i = std::get<0>(constraint);
+      const int j = std::get<1>(constraint);
+      const double d2 = std::get<2>(constraint);
+      const Eigen::RowVector3d r = _positions.row(i) - _positions.row(j);
+      const Eigen::RowVector3d v = _velocities.row(i) - _velocities.row(j);
+      const double rv = r.dot(v);
+      if (std::abs(rv) <= tolerance * d2) {
+        continue;
+      }
+      converged = false;
+      const double k = rv / (d2 * (1.0 / _masses[i] + 1.0 / _masses[j]));
+      _velocities.row(i) -= k / _masses[i] * r;
+      _velocities.row(j) += k / _masses[j] * r;
+    }
+    if (converged) {
+      return;
+    }
+  }
+  throw std::runtime_error("RATTLE did not converge.");
+}
+
+double MolecularDynamics::_kineticEnergy() const {
+  return 0.5 * (_masses.asDiagonal() * _velocities.cwiseAbs2()).sum();
+}
+
+double MolecularDynamics::_temperature(double kineticEnergy) const {
+  const int nAtoms = _positions.rows();
+  const int degreesOfFreedom = 3 * nAtoms - static_cast<int>(_constraints.size()) - (nAtoms > 1 ? 3 : 0);
+  if (degreesOfFreedom <= 0) {
+    return 0.0;
+  }
+  return 2.0 * kineticEnergy / (degreesOfFreedom * boltzmannConstant);
+}
+
+void MolecularDynamics::_record(int step, double time) {
+  if (!_sink) {
+    return;
+  }
+  const double kineticEnergy = _kineticEnergy();
+  _sink({step, time, _positions, _velocities, _potentialEnergy, kineticEnergy, _temperature(kineticEnergy)});
+}
+
+} /* namespace Xtb */
+} /* namespace Scine */
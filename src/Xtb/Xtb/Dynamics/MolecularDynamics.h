@@ -0,0 +1,119 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_MOLECULARDYNAMICS_H_
+#define XTB_MOLECULARDYNAMICS_H_
+
+/* Internal Includes */
+#include "Xtb/Dynamics/MolecularDynamicsSettings.h"
+/* External Includes */
+#include <Utils/Geometry/AtomCollection.h>
+#include <Utils/Typenames.h>
+#include <functional>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace Scine {
+namespace Xtb {
+
+class XtbCalculatorBase;
+class XtbSession;
+
+/**
+ * @brief A snapshot of a molecular dynamics trajectory.
+ *
+ * All quantities are given in atomic units (bohr, hartree, atomic time units),
+ * except for the time, which is given in femtoseconds, and the temperature,
+ * which is given in Kelvin.
+ */
+struct MolecularDynamicsFrame {
+  int step;
+  double time;
+  Utils::PositionCollection positions;
+  Utils::DisplacementCollection velocities;
+  double potentialEnergy;
+  double kineticEnergy;
+  double temperature;
+};
+
+/**
+ * @class MolecularDynamics
+ * @brief Born-Oppenheimer molecular dynamics on top of a single xtb session.
+ *
+ * The equations of motion are integrated with the velocity Verlet algorithm,
+ * optionally coupled to a Berendsen or Langevin thermostat and with the bonds
+ * to hydrogen atoms constrained by SHAKE/RATTLE. The parametrized xtb
+ * calculator and the wavefunction are kept for the whole trajectory, such
+ * that each step only costs one warm-started SCF. Frames are passed to a
+ * user-defined sink instead of being accumulated in memory.
+ */
+class MolecularDynamics {
+ public:
+  using FrameSink = std::function<void(const MolecularDynamicsFrame&)>;
+  /**
+   * @brief Constructor.
+   * @param calculator The calculator defining the method and its settings.
+   */
+  explicit MolecularDynamics(XtbCalculatorBase& calculator);
+  /// @brief Accessor for the settings of the molecular dynamics.
+  Utils::Settings& settings();
+  /// @brief Const accessor for the settings of the molecular dynamics.
+  const Utils::Settings& settings() const;
+  /**
+   * @brief Sets the sink receiving every n-th frame (see the record frequency setting).
+   * @param sink The sink.
+   */
+  void setFrameSink(FrameSink sink);
+  /**
+   * @brief Sets the initial velocities in atomic units, replacing the
+   *        Maxwell-Boltzmann initialization for the next run.
+   * @param velocities The velocities.
+   */
+  void setInitialVelocities(Utils::DisplacementCollection velocities);
+  /**
+   * @brief Runs the molecular dynamics simulation.
+   *
+   * The structure is set in the calculator, at the end of the run the
+   * positions of the calculator are updated to the final positions.
+   *
+   * @param structure The initial structure.
+   */
+  void performMD(const Utils::AtomCollection& structure);
+  /// @brief Getter for the positions after the last step.
+  const Utils::PositionCollection& getPositions() const;
+  /// @brief Getter for the velocities after the last step.
+  const Utils::DisplacementCollection& getVelocities() const;
+  /// @brief Getter for the potential energy after the last step.
+  double getPotentialEnergy() const;
+
+ private:
+  void _evaluate(XtbSession& session);
+  void _initializeVelocities(std::mt19937& generator);
+  void _detectConstraints(const Utils::AtomCollection& structure);
+  void _shake(const Utils::PositionCollection& oldPositions, double timeStep);
+  void _rattle();
+  double _kineticEnergy() const;
+  double _temperature(double kineticEnergy) const;
+  void _record(int step, double time);
+
+  XtbCalculatorBase& _calculator;
+  MolecularDynamicsSettings _settings;
+  FrameSink _sink;
+  Utils::DisplacementCollection _initialVelocities;
+  Utils::PositionCollection _positions;
+  Utils::DisplacementCollection _velocities;
+  Utils::GradientCollection _gradients;
+  Eigen::VectorXd _masses;
+  double _potentialEnergy = 0.0;
+  // Pairs of constrained atoms and their squared distance
+  std::vector<std::tuple<int, int, double>> _constraints;
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_MOLECULARDYNAMICS_H_ */
@@ -0,0 +1,87 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Dynamics/MolecularDynamicsSettings.h"
+
+namespace Scine {
+namespace Xtb {
+
+MolecularDynamicsSettings::MolecularDynamicsSettings() : Scine::Utils::Settings("MolecularDynamicsSettings") {
+  using namespace Scine::Utils::UniversalSettings;
+  namespace Names = MolecularDynamicsSettingsNames;
+
+  // Time step
+  DoubleDescriptor timeStep("The time step of the velocity Verlet integration in femtoseconds.");
+  timeStep.setMinimum(0.0);
+  timeStep.setDefaultValue(1.0);
+  this->_fields.push_back(Names::timeStep, timeStep);
+
+  // Number of steps
+  IntDescriptor numberOfSteps("The number of integration steps.");
+  numberOfSteps.setMinimum(0);
+  numberOfSteps.setDefaultValue(100);
+  this->_fields.push_back(Names::numberOfSteps, numberOfSteps);
+
+  // Thermostat
+  OptionListDescriptor thermostat("The thermostat, 'none' samples the microcanonical ensemble.");
+  thermostat.addOption("none");
+  thermostat.addOption("berendsen");
+  thermostat.addOption("langevin");
+  thermostat.setDefaultOption("none");
+  this->_fields.push_back(Names::thermostat, thermostat);
+
+  // Target temperature
+  DoubleDescriptor targetTemperature("The temperature of the heat bath in K.");
+  targetTemperature.setMinimum(0.0);
+  targetTemperature.setDefaultValue(298.15);
+  this->_fields.push_back(Names::targetTemperature, targetTemperature);
+
+  // Coupling time
+  DoubleDescriptor couplingTime("The coupling time of the thermostat in femtoseconds. This is the relaxation "
+                                "time of the Berendsen thermostat and the inverse friction of the Langevin "
+                                "thermostat.");
+  couplingTime.setMinimum(0.0);
+  couplingTime.setDefaultValue(100.0);
+  this->_fields.push_back(Names::couplingTime, couplingTime);
+
+  // Initial temperature
+  DoubleDescriptor initialTemperature("The temperature in K of the Maxwell-Boltzmann distribution the initial "
+                                      "velocities are drawn from. Ignored if initial velocities are given.");
+  initialTemperature.setMinimum(0.0);
+  initialTemperature.setDefaultValue(298.15);
+  this->_fields.push_back(Names::initialTemperature, initialTemperature);
+
+  // SHAKE
+  BoolDescriptor constrainHydrogenBonds("Whether the lengths of all bonds to hydrogen atoms are kept fixed with "
+                                        "SHAKE/RATTLE.");
+  constrainHydrogenBonds.setDefaultValue(false);
+  this->_fields.push_back(Names::constrainHydrogenBonds, constrainHydrogenBonds);
+
+  // SHAKE tolerance
+  DoubleDescriptor constraintTolerance("The relative tolerance of the bond length constraints.");
+  constraintTolerance.setMinimum(0.0);
+  constraintTolerance.setDefaultValue(1e-8);
+  this->_fields.push_back(Names::constraintTolerance, constraintTolerance);
+
+  // Seed
+  IntDescriptor seed("The seed of the random number generator for the initial velocities and the Langevin "
+                     "thermostat.");
+  seed.setDefaultValue(42);
+  this->_fields.push_back(Names::seed, seed);
+
+  // Record frequency
+  IntDescriptor recordFrequency("Every how many steps a frame is passed to the frame sink.");
+  recordFrequency.setMinimum(1);
+  recordFrequency.setDefaultValue(1);
+  this->_fields.push_back(Names::recordFrequency, recordFrequency);
+
+  this->resetToDefaults();
+}
+
+} /* namespace Xtb */
+} /* namespace Scine */
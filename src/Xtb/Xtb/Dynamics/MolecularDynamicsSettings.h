@@ -0,0 +1,44 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_MOLECULARDYNAMICSSETTINGS_H_
+#define XTB_MOLECULARDYNAMICSSETTINGS_H_
+
+/* External Includes */
+#include <Utils/Settings.h>
+
+namespace Scine {
+namespace Xtb {
+
+namespace MolecularDynamicsSettingsNames {
+static constexpr const char* timeStep = "time_step";
+static constexpr const char* numberOfSteps = "number_of_steps";
+static constexpr const char* thermostat = "thermostat";
+static constexpr const char* targetTemperature = "target_temperature";
+static constexpr const char* couplingTime = "thermostat_coupling_time";
+static constexpr const char* initialTemperature = "initial_temperature";
+static constexpr const char* constrainHydrogenBonds = "constrain_hydrogen_bonds";
+static constexpr const char* constraintTolerance = "constraint_tolerance";
+static constexpr const char* seed = "seed";
+static constexpr const char* recordFrequency = "record_frequency";
+} // namespace MolecularDynamicsSettingsNames
+
+/**
+ * @class MolecularDynamicsSettings
+ * @brief The settings of the xtb molecular dynamics driver.
+ */
+class MolecularDynamicsSettings : public Scine::Utils::Settings {
+ public:
+  /**
+   * @brief Construct a new MolecularDynamicsSettings object.
+   */
+  MolecularDynamicsSettings();
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_MOLECULARDYNAMICSSETTINGS_H_ */
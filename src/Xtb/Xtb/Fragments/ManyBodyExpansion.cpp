@@ -0,0 +1,310 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Fragments/ManyBodyExpansion.h"
+#include "Xtb/Wrapper/XtbCalculatorBase.h"
+/* External Includes */
+#include <Utils/Bonds/BondDetector.h>
+#include <Utils/Bonds/BondOrderCollection.h>
+#include <Utils/Geometry/ElementInfo.h>
+#include <Utils/UniversalSettings/SettingsNames.h>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <map>
+#include <numeric>
+
+namespace Scine {
+namespace Xtb {
+
+ManyBodyExpansion::ManyBodyExpansion(const XtbCalculatorBase& calculator) : _calculator(calculator) {
+}
+
+Utils::Settings& ManyBodyExpansion::settings() {
+  return _settings;
+}
+
+const Utils::Settings& ManyBodyExpansion::settings() const {
+  return _settings;
+}
+
+const std::vector<std::vector<int>>& ManyBodyExpansion::getFragments() const {
+  return _fragments;
+}
+
+int ManyBodyExpansion::getNumberOfFragmentCalculations() const {
+  return _nCalculations;
+}
+
+Utils::Results ManyBodyExpansion::calculate(const Utils::AtomCollection& structure,
+                                            const Utils::PropertyList& properties) {
+  namespace Names = ManyBodyExpansionSettingsNames;
+  if (!_settings.valid()) {
+    _settings.throwIncorrectSettings();
+  }
+  if (!(Utils::Property::Energy | Utils::Property::Gradients).containsSubSet(properties)) {
+    throw std::runtime_error("The many-body expansion only provides energies and gradients.");
+  }
+  const bool gradients = properties.containsSubSet(Utils::Property::Gradients);
+  const bool embedding = _settings.getBool(Names::embedding);
+  if (embedding && !_calculator.possibleProperties().containsSubSet(Utils::Property::AtomicCharges |
+                                                                     Utils::Property::PointChargesGradients)) {
+    throw std::runtime_error("The " + _calculator.name() + " calculator does not support electrostatic embedding.");
+  }
+  _partition(structure);
+  const int nFragments = static_cast<int>(_fragments.size());
+  const int order = _settings.getInt(Names::expansionOrder);
+  const double dimerCutoff = _settings.getDouble(Names::dimerCutoff);
+  const double trimerCutoff = _settings.getDouble(Names::trimerCutoff);
+  _nCalculations = 0;
+
+  // Monomers
+  std::vector<FragmentJob> jobs(nFragments);
+  for (int i = 0; i < nFragments; ++i) {
+    jobs[i].fragments = {i};
+  }
+  std::vector<double> embeddingCharges;
+  if (embedding) {
+    _run(jobs, structure, false, true, embeddingCharges);
+    embeddingCharges.assign(structure.size(), 0.0);
+    for (const auto& job : jobs) {
+      for (unsigned k = 0; k < job.atoms.size(); ++k) {
+        embeddingCharges[job.atoms[k]] = job.charges[k];
+      }
+    }
+  }
+  // Dimers and trimers
+  std::map<std::pair<int, int>, bool> dimers;
+  if (order > 1) {
+    for (int i = 0; i < nFragments; ++i) {
+      for (int j = i + 1; j < nFragments; ++j) {
+        const double distance = _distance(i, j, structure);
+        if (distance < dimerCutoff) {
+          dimers[{i, j}] = distance < trimerCutoff;
+          jobs.push_back(FragmentJob());
+          jobs.back().fragments = {i, j};
+        }
+      }
+    }
+  }
+  if (order > 2) {
+    for (const auto& ij : dimers) {
+      if (!ij.second) {
+        continue;
+      }
+      const int i = ij.first.first;
+      const int j = ij.first.second;
+      for (int k = j + 1; k < nFragments; ++k) {
+        auto ik = dimers.find({i, k});
+        auto jk = dimers.find({j, k});
+        if (ik != dimers.end() && ik->second && jk != dimers.end() && jk->second) {
+          jobs.push_back(FragmentJob());
+          jobs.back().fragments = {i, j, k};
+        }
+      }
+    }
+  }
+  _run(jobs, structure, gradients, false, embeddingCharges);
+
+  // Coefficients of each fragment calculation in the expansion
+  std::map<std::vector<int>, int> index;
+  for (unsigned n = 0; n < jobs.size(); ++n) {
+    index[jobs[n].fragments] = n;
+  }
+  std::vector<int> coefficients(jobs.size(), 0);
+  for (unsigned n = 0; n < jobs.size(); ++n) {
+    const auto& f = jobs[n].fragments;
+    coefficients[n] += 1;
+    if (f.size() == 2) {
+      coefficients[index.at({f[0]})] -= 1;
+      coefficients[index.at({f[1]})] -= 1;
+    }
+    else if (f.size() == 3) {
+      coefficients[index.at({f[0], f[1]})] -= 1;
+      coefficients[index.at({f[0], f[2]})] -= 1;
+      coefficients[index.at({f[1], f[2]})] -= 1;
+      coefficients[index.at({f[0]})] += 1;
+      coefficients[index.at({f[1]})] += 1;
+      coefficients[index.at({f[2]})] += 1;
+    }
+  }
+
+  // Assemble
+  double energy = 0.0;
+  Utils::GradientCollection totalGradients = Utils::GradientCollection::Zero(structure.size(), 3);
+  for (unsigned n = 0; n < jobs.size(); ++n) {
+    if (coefficients[n] == 0) {
+      continue;
+    }
+    const auto& job = jobs[n];
+    energy += coefficients[n] * job.energy;
+    if (gradients) {
+      for (unsigned k = 0; k < job.atoms.size(); ++k) {
+        totalGradients.row(job.atoms[k]) += coefficients[n] * job.gradients.row(k);
+      }
+      // Gradients on the embedding charges, i.e. on the remaining atoms
+      for (int k = static_cast<int>(job.atoms.size()); k < job.gradients.rows(); ++k) {
+        totalGradients.row(job.embeddingAtoms[k - job.atoms.size()]) += coefficients[n] * job.gradients.row(k);
+      }
+    }
+  }
+  Utils::Results results;
+  results.set<Utils::Property::Energy>(energy);
+  if (gradients) {
+    results.set<Utils::Property::Gradients>(totalGradients);
+  }
+  results.set<Utils::Property::SuccessfulCalculation>(true);
+  results.set<Utils::Property::ProgramName>("Xtb");
+  return results;
+}
+
+void ManyBodyExpansion::_partition(const Utils::AtomCollection& structure) {
+  const int nAtoms = structure.size();
+  const auto fragmentIndices = _settings.getIntList(ManyBodyExpansionSettingsNames::fragmentIndices);
+  std::vector<int> labels(nAtoms);
+  if (!fragmentIndices.empty()) {
+    if (static_cast<int>(fragmentIndices.size()) != nAtoms) {
+      throw std::runtime_error("The number of fragment indices does not match the number of atoms.");
+    }
+    labels = fragmentIndices;
+  }
+  else {
+    // Connected components of the bond graph (union-find)
+    std::iota(labels.begin(), labels.end(), 0);
+    std::function<int(int)> root = [&](int i) { return labels[i] == i ? i : labels[i] = root(labels[i]); };
+    const auto bondOrders = Utils::BondDetector::detectBonds(structure);
+    const auto& matrix = bondOrders.getMatrix();
+    for (int k = 0; k < matrix.outerSize(); ++k) {
+      for (Eigen::SparseMatrix<double>::InnerIterator it(matrix, k); it; ++it) {
+        if (it.value() > 0.5) {
+          labels[root(static_cast<int>(it.row()))] = root(static_cast<int>(it.col()));
+        }
+      }
+    }
+    for (int i = 0; i < nAtoms; ++i) {
+      labels[i] = root(i);
+    }
+  }
+  std::map<int, int> fragmentOfLabel;
+  _fragments.clear();
+  for (int i = 0; i < nAtoms; ++i) {
+    auto it = fragmentOfLabel.find(labels[i]);
+    if (it == fragmentOfLabel.end()) {
+      it = fragmentOfLabel.emplace(labels[i], static_cast<int>(_fragments.size())).first;
+      _fragments.emplace_back();
+    }
+    _fragments[it->second].push_back(i);
+  }
+}
+
+void ManyBodyExpansion::_run(std::vector<FragmentJob>& jobs, const Utils::AtomCollection& structure, bool gradients,
+                             bool charges, const std::vector<double>& embeddingCharges) {
+  const auto fragmentCharges = _settings.getIntList(ManyBodyExpansionSettingsNames::fragmentCharges);
+  if (!fragmentCharges.empty() && fragmentCharges.size() != _fragments.size()) {
+    throw std::runtime_error("The number of fragment charges does not match the number of fragments.");
+  }
+  std::exception_ptr error = nullptr;
+#pragma omp parallel for schedule(dynamic)
+  for (int n = 0; n < static_cast<int>(jobs.size()); ++n) {
+    try {
+      auto& job = jobs[n];
+      // Atoms and charge of the fragment calculation
+      job.atoms.clear();
+      int charge = 0;
+      for (const auto fragment : job.fragments) {
+        job.atoms.insert(job.atoms.end(), _fragments[fragment].begin(), _fragments[fragment].end());
+        charge += fragmentCharges.empty() ? 0 : fragmentCharges[fragment];
+      }
+      Utils::AtomCollection subsystem(static_cast<int>(job.atoms.size()));
+      int nElectrons = -charge;
+      for (unsigned k = 0; k < job.atoms.size(); ++k) {
+        subsystem.setElement(k, structure.getElement(job.atoms[k]));
+        subsystem.setPosition(k, structure.getPosition(job.atoms[k]));
+        nElectrons += Utils::ElementInfo::Z(structure.getElement(job.atoms[k]));
+      }
+      auto calculator = _calculator.clone();
+      auto& settings = calculator->settings();
+      settings.modifyInt(Utils::SettingsNames::externalProgramNProcs, 1);
+      settings.modifyInt(Utils::SettingsNames::molecularCharge, charge);
+      settings.modifyInt(Utils::SettingsNames::spinMultiplicity, (nElectrons % 2 == 0) ? 1 : 2);
+      Utils::PropertyList properties(Utils::Property::Energy);
+      if (gradients) {
+        properties.addProperty(Utils::Property::Gradients);
+      }
+      if (charges) {
+        properties.addProperty(Utils::Property::AtomicCharges);
+      }
+      // Embedding in the monomer charges of all other atoms
+      auto& embeddingAtoms = job.embeddingAtoms;
+      embeddingAtoms.clear();
+      if (!embeddingCharges.empty()) {
+        std::vector<bool> inFragment(structure.size(), false);
+        for (const auto atom : job.atoms) {
+          inFragment[atom] = true;
+        }
+        std::vector<double> pointCharges;
+        for (int atom = 0; atom < structure.size(); ++atom) {
+          if (inFragment[atom]) {
+            continue;
+          }
+          const auto position = structure.getPosition(atom);
+          const auto atomicNumber = static_cast<double>(Utils::ElementInfo::Z(structure.getElement(atom)));
+          pointCharges.insert(pointCharges.end(),
+                              {embeddingCharges[atom], atomicNumber, position.x(), position.y(), position.z()});
+          embeddingAtoms.push_back(atom);
+        }
+        settings.modifyDoubleList(Utils::SettingsNames::mmCharges, pointCharges);
+        if (gradients && !embeddingAtoms.empty()) {
+          properties.addProperty(Utils::Property::PointChargesGradients);
+        }
+      }
+      calculator->setStructure(subsystem);
+      calculator->setRequiredProperties(properties);
+      const auto& results = calculator->calculate("");
+      job.energy = results.get<Utils::Property::Energy>();
+      if (charges) {
+        job.charges = results.get<Utils::Property::AtomicCharges>();
+      }
+      if (gradients) {
+        // The gradients on the embedding charges are appended to the fragment gradients
+        const auto& fragmentGradients = results.get<Utils::Property::Gradients>();
+        job.gradients.resize(fragmentGradients.rows() + static_cast<long>(embeddingAtoms.size()), 3);
+        job.gradients.topRows(fragmentGradients.rows()) = fragmentGradients;
+        if (!embeddingAtoms.empty()) {
+          job.gradients.bottomRows(embeddingAtoms.size()) = results.get<Utils::Property::PointChargesGradients>();
+        }
+      }
+    }
+    catch (...) {
+#pragma omp critical(XtbManyBodyExpansionError)
+      {
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  _nCalculations += static_cast<int>(jobs.size());
+}
+
+double ManyBodyExpansion::_distance(int fragmentA, int fragmentB, const Utils::AtomCollection& structure) const {
+  double shortest = std::numeric_limits<double>::infinity();
+  const auto& positions = structure.getPositions();
+  for (const auto i : _fragments[fragmentA]) {
+    for (const auto j : _fragments[fragmentB]) {
+      shortest = std::min(shortest, (positions.row(i) - positions.row(j)).norm());
+    }
+  }
+  return shortest;
+}
+
+} /* namespace Xtb */
+} /* namespace Scine */
@@ -0,0 +1,83 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_MANYBODYEXPANSION_H_
+#define XTB_MANYBODYEXPANSION_H_
+
+/* Internal Includes */
+#include "Xtb/Fragments/ManyBodyExpansionSettings.h"
+/* External Includes */
+#include <Utils/CalculatorBasics.h>
+#include <Utils/Geometry/AtomCollection.h>
+#include <vector>
+
+namespace Scine {
+namespace Xtb {
+
+class XtbCalculatorBase;
+
+/**
+ * @class ManyBodyExpansion
+ * @brief Fragment-based many-body expansion of the energy and gradient.
+ *
+ * The structure is partitioned into fragments, either by the connectivity of
+ * the atoms or by a user-given list. The energy is assembled from the energies
+ * of all monomers, of the dimers within a distance cutoff and optionally of
+ * the trimers within a second cutoff:
+ *   E = sum_I E_I + sum_IJ dE_IJ + sum_IJK dE_IJK.
+ * The fragment calculations are independent of each other and are run in
+ * parallel, each with a clone of the given calculator. Optionally, each
+ * calculation is embedded in the atomic charges of the isolated monomers of
+ * all other fragments.
+ */
+class ManyBodyExpansion {
+ public:
+  /**
+   * @brief Constructor.
+   * @param calculator The calculator defining the method and its settings,
+   *                   it is cloned for each fragment calculation.
+   */
+  explicit ManyBodyExpansion(const XtbCalculatorBase& calculator);
+  /// @brief Accessor for the settings of the expansion.
+  Utils::Settings& settings();
+  /// @brief Const accessor for the settings of the expansion.
+  const Utils::Settings& settings() const;
+  /**
+   * @brief Calculates the many-body expansion of the given structure.
+   * @param structure  The full structure.
+   * @param properties The required properties, energy and optionally gradients.
+   * @return Utils::Results The energy and, if required, the gradients.
+   */
+  Utils::Results calculate(const Utils::AtomCollection& structure, const Utils::PropertyList& properties);
+  /// @brief The atom indices of each fragment of the last calculation.
+  const std::vector<std::vector<int>>& getFragments() const;
+  /// @brief The number of fragment calculations of the last calculation.
+  int getNumberOfFragmentCalculations() const;
+
+ private:
+  struct FragmentJob {
+    std::vector<int> fragments;
+    std::vector<int> atoms;
+    double energy = 0.0;
+    Utils::GradientCollection gradients;
+    std::vector<double> charges;
+    std::vector<int> embeddingAtoms;
+  };
+  void _partition(const Utils::AtomCollection& structure);
+  void _run(std::vector<FragmentJob>& jobs, const Utils::AtomCollection& structure, bool gradients, bool charges,
+            const std::vector<double>& embeddingCharges);
+  double _distance(int fragmentA, int fragmentB, const Utils::AtomCollection& structure) const;
+
+  const XtbCalculatorBase& _calculator;
+  ManyBodyExpansionSettings _settings;
+  std::vector<std::vector<int>> _fragments;
+  int _nCalculations = 0;
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_MANYBODYEXPANSION_H_ */
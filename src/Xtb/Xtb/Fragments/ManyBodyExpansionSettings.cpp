@@ -0,0 +1,57 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Fragments/ManyBodyExpansionSettings.h"
+
+namespace Scine {
+namespace Xtb {
+
+ManyBodyExpansionSettings::ManyBodyExpansionSettings() : Scine::Utils::Settings("ManyBodyExpansionSettings") {
+  using namespace Scine::Utils::UniversalSettings;
+  namespace Names = ManyBodyExpansionSettingsNames;
+
+  // Fragmentation
+  IntListDescriptor fragmentIndices("The fragment index of each atom. If empty, the fragments are the connected "
+                                    "components of the bond graph of the structure.");
+  fragmentIndices.setItemMinimum(0);
+  this->_fields.push_back(Names::fragmentIndices, fragmentIndices);
+
+  IntListDescriptor fragmentCharges("The molecular charge of each fragment. If empty, all fragments are neutral.");
+  this->_fields.push_back(Names::fragmentCharges, fragmentCharges);
+
+  // Expansion
+  IntDescriptor expansionOrder("The order of the many-body expansion, 1 (monomers), 2 (dimers) or 3 (trimers).");
+  expansionOrder.setMinimum(1);
+  expansionOrder.setMaximum(3);
+  expansionOrder.setDefaultValue(2);
+  this->_fields.push_back(Names::expansionOrder, expansionOrder);
+
+  DoubleDescriptor dimerCutoff("Dimers are only evaluated if the shortest interatomic distance between their "
+                               "fragments is below this cutoff in bohr.");
+  dimerCutoff.setMinimum(0.0);
+  dimerCutoff.setDefaultValue(15.0);
+  this->_fields.push_back(Names::dimerCutoff, dimerCutoff);
+
+  DoubleDescriptor trimerCutoff("Trimers are only evaluated if the shortest interatomic distance between each pair "
+                                "of their fragments is below this cutoff in bohr.");
+  trimerCutoff.setMinimum(0.0);
+  trimerCutoff.setDefaultValue(8.0);
+  this->_fields.push_back(Names::trimerCutoff, trimerCutoff);
+
+  // Embedding
+  BoolDescriptor embedding("Whether each fragment calculation is embedded in the atomic charges of the isolated "
+                           "monomers of all other fragments. Requires a method providing atomic charges and point "
+                           "charge gradients.");
+  embedding.setDefaultValue(false);
+  this->_fields.push_back(Names::embedding, embedding);
+
+  this->resetToDefaults();
+}
+
+} /* namespace Xtb */
+} /* namespace Scine */
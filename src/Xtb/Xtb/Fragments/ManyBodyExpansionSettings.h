@@ -0,0 +1,40 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_MANYBODYEXPANSIONSETTINGS_H_
+#define XTB_MANYBODYEXPANSIONSETTINGS_H_
+
+/* External Includes */
+#include <Utils/Settings.h>
+
+namespace Scine {
+namespace Xtb {
+
+namespace ManyBodyExpansionSettingsNames {
+static constexpr const char* fragmentIndices = "fragment_indices";
+static constexpr const char* fragmentCharges = "fragment_charges";
+static constexpr const char* expansionOrder = "expansion_order";
+static constexpr const char* dimerCutoff = "dimer_cutoff";
+static constexpr const char* trimerCutoff = "trimer_cutoff";
+static constexpr const char* embedding = "electrostatic_embedding";
+} // namespace ManyBodyExpansionSettingsNames
+
+/**
+ * @class ManyBodyExpansionSettings
+ * @brief The settings of the fragment-based many-body expansion.
+ */
+class ManyBodyExpansionSettings : public Scine::Utils::Settings {
+ public:
+  /**
+   * @brief Construct a new ManyBodyExpansionSettings object.
+   */
+  ManyBodyExpansionSettings();
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_MANYBODYEXPANSIONSETTINGS_H_ */
@@ -0,0 +1,186 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Hessian/SymmetryDetector.h"
+/* External Includes */
+#include <Utils/Geometry/ElementInfo.h>
+#include <Eigen/Eigenvalues>
+#include <Eigen/Geometry>
+#include <algorithm>
+#include <cmath>
+
+namespace Scine {
+namespace Xtb {
+
+Eigen::VectorXd SymmetryOperation::apply(const Eigen::VectorXd& atomVectors) const {
+  Eigen::VectorXd result(atomVectors.size());
+  for (unsigned i = 0; i < permutation.size(); ++i) {
+    result.segment<3>(3 * permutation[i]) = matrix * atomVectors.segment<3>(3 * i);
+  }
+  return result;
+}
+
+namespace {
+// The largest set of equivalent atoms used to generate candidate elements from pairs
+constexpr unsigned maxPairCandidates = 24;
+// The highest order of the rotation axes
+constexpr int maxOrder = 8;
+// The order of the largest finite point group (I_h)
+constexpr unsigned maxOperations = 120;
+
+bool tryOperation(const Eigen::Matrix3d& matrix, const Eigen::MatrixXd& positions,
+                  const Utils::ElementTypeCollection& elements, double tolerance, std::vector<int>& permutation) {
+  const int nAtoms = positions.rows();
+  permutation.assign(nAtoms, -1);
+  std::vector<bool> taken(nAtoms, false);
+  for (int i = 0; i < nAtoms; ++i) {
+    const Eigen::RowVector3d image = (matrix * positions.row(i).transpose()).transpose();
+    for (int j = 0; j < nAtoms; ++j) {
+      if (!taken[j] && elements[j] == elements[i] && (positions.row(j) - image).norm() < tolerance) {
+        permutation[i] = j;
+        taken[j] = true;
+        break;
+      }
+    }
+    if (permutation[i] < 0) {
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+std::vector<SymmetryOperation> SymmetryDetector::detect(const Utils::AtomCollection& structure, double tolerance) {
+  const int nAtoms = structure.size();
+  const auto& elements = structure.getElements();
+  std::vector<SymmetryOperation> operations;
+  SymmetryOperation identity;
+  identity.matrix = Eigen::Matrix3d::Identity();
+  for (int i = 0; i < nAtoms; ++i) {
+    identity.permutation.push_back(i);
+  }
+  operations.push_back(identity);
+  if (nAtoms < 2) {
+    return operations;
+  }
+
+  // Positions relative to the center of mass and the principal axes of inertia
+  Eigen::MatrixXd positions = structure.getPositions();
+  Eigen::RowVector3d centerOfMass = Eigen::RowVector3d::Zero();
+  double totalMass = 0.0;
+  for (int i = 0; i < nAtoms; ++i) {
+    const double mass = Utils::ElementInfo::mass(elements[i]);
+    centerOfMass += mass * positions.row(i);
+    totalMass += mass;
+  }
+  positions.rowwise() -= centerOfMass / totalMass;
+  Eigen::Matrix3d inertia = Eigen::Matrix3d::Zero();
+  for (int i = 0; i < nAtoms; ++i) {
+    const Eigen::Vector3d r = positions.row(i).transpose();
+    const double mass = Utils::ElementInfo::mass(elements[i]);
+    inertia += mass * (r.squaredNorm() * Eigen::Matrix3d::Identity() - r * r.transpose());
+  }
+  Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> principal(inertia);
+
+  // Candidate axes
+  std::vector<Eigen::Vector3d> axes;
+  auto addAxis = [&](const Eigen::Vector3d& axis) {
+    if (axis.norm() < tolerance) {
+      return;
+    }
+    const Eigen::Vector3d normalized = axis.normalized();
+    for (const auto& existing : axes) {
+      if (std::abs(existing.dot(normalized)) > 1.0 - 1e-8) {
+        return;
+      }
+    }
+    axes.push_back(normalized);
+  };
+  for (int k = 0; k < 3; ++k) {
+    addAxis(principal.eigenvectors().col(k));
+  }
+  // The smallest set of potentially equivalent atoms away from the center
+  std::vector<int> order(nAtoms);
+  for (int i = 0; i < nAtoms; ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&](int a, int b) {
+    return elements[a] != elements[b] ? elements[a] < elements[b] : positions.row(a).norm() < positions.row(b).norm();
+  });
+  std::vector<std::vector<int>> sets;
+  for (int k = 0; k < nAtoms; ++k) {
+    const int i = order[k];
+    const double radius = positions.row(i).norm();
+    if (radius < tolerance) {
+      continue;
+    }
+    const int previous = (k > 0) ? order[k - 1] : -1;
+    if (sets.empty() || previous < 0 || elements[previous] != elements[i] ||
+        radius - positions.row(previous).norm() > tolerance) {
+      sets.emplace_back();
+    }
+    sets.back().push_back(i);
+  }
+  const std::vector<int>* smallest = nullptr;
+  for (const auto& set : sets) {
+    if (!smallest || set.size() < smallest->size()) {
+      smallest = &set;
+    }
+  }
+  if (smallest) {
+    for (const auto i : *smallest) {
+      addAxis(positions.row(i).transpose());
+    }
+    if (smallest->size() <= maxPairCandidates) {
+      for (unsigned a = 0; a < smallest->size(); ++a) {
+        for (unsigned b = a + 1; b < smallest->size(); ++b) {
+          const Eigen::Vector3d ri = positions.row((*smallest)[a]).transpose();
+          const Eigen::Vector3d rj = positions.row((*smallest)[b]).transpose();
+          addAxis(ri + rj);
+          addAxis(ri - rj);
+          addAxis(ri.cross(rj));
+        }
+      }
+    }
+  }
+
+  // Verify the candidate operations
+  std::vector<int> permutation;
+  auto tryAdd = [&](const Eigen::Matrix3d& matrix) {
+    for (const auto& operation : operations) {
+      if ((operation.matrix - matrix).norm() < 1e-6) {
+        return;
+      }
+    }
+    if (tryOperation(matrix, positions, elements, tolerance, permutation)) {
+      operations.push_back({matrix, permutation});
+    }
+  };
+  tryAdd(-Eigen::Matrix3d::Identity());
+  for (const auto& axis : axes) {
+    const Eigen::Matrix3d reflection = Eigen::Matrix3d::Identity() - 2.0 * axis * axis.transpose();
+    tryAdd(reflection);
+    for (int n = 2; n <= maxOrder; ++n) {
+      const Eigen::Matrix3d rotation = Eigen::AngleAxisd(2.0 * M_PI / n, axis).toRotationMatrix();
+      tryAdd(rotation);
+      tryAdd(reflection * rotation);
+    }
+  }
+
+  // Closure under multiplication, the products are verified as well since the
+  // operations are only exact within the tolerance
+  for (unsigned a = 0; a < operations.size() && operations.size() < maxOperations; ++a) {
+    for (unsigned b = 0; b < operations.size() && operations.size() < maxOperations; ++b) {
+      tryAdd(operations[a].matrix * operations[b].matrix);
+    }
+  }
+  return operations;
+}
+
+} /* namespace Xtb */
+} /* namespace Scine */
@@ -0,0 +1,60 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_SYMMETRYDETECTOR_H_
+#define XTB_SYMMETRYDETECTOR_H_
+
+/* External Includes */
+#include <Utils/Geometry/AtomCollection.h>
+#include <Eigen/Core>
+#include <vector>
+
+namespace Scine {
+namespace Xtb {
+
+/**
+ * @struct SymmetryOperation
+ * @brief A point group operation of a structure.
+ */
+struct SymmetryOperation {
+  /// @brief The orthogonal matrix acting on positions relative to the center of mass.
+  Eigen::Matrix3d matrix;
+  /// @brief The atom each atom is mapped onto.
+  std::vector<int> permutation;
+  /**
+   * @brief Applies the operation to a per-atom vector quantity, e.g. a gradient
+   *        or a column of the Hessian, given as 3N vector.
+   */
+  Eigen::VectorXd apply(const Eigen::VectorXd& atomVectors) const;
+};
+
+/**
+ * @class SymmetryDetector
+ * @brief Detection of the point group operations of a structure.
+ *
+ * Candidate rotation axes and mirror planes are generated from the principal
+ * axes of inertia and from the smallest set of potentially equivalent atoms
+ * (same element, same distance from the center of mass), each candidate is
+ * verified by mapping all atoms onto each other within the tolerance, and the
+ * verified operations are closed under multiplication. Every returned
+ * operation is verified, but high-order or unusual elements may be missed,
+ * which only reduces the exploitable symmetry.
+ */
+class SymmetryDetector {
+ public:
+  /**
+   * @brief Detects the point group operations of a structure.
+   * @param structure The structure.
+   * @param tolerance The maximum deviation of a mapped atom in bohr.
+   * @return std::vector<SymmetryOperation> The operations, the identity first.
+   */
+  static std::vector<SymmetryOperation> detect(const Utils::AtomCollection& structure, double tolerance);
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_SYMMETRYDETECTOR_H_ */
@@ -0,0 +1,230 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Multilevel/Oniom.h"
+#include "Xtb/Wrapper/XtbCalculatorBase.h"
+/* External Includes */
+#include <Utils/Bonds/BondDetector.h>
+#include <Utils/Bonds/BondOrderCollection.h>
+#include <Utils/Geometry/ElementInfo.h>
+#include <Utils/UniversalSettings/SettingsNames.h>
+#include <exception>
+
+namespace Scine {
+namespace Xtb {
+
+Oniom::Oniom(const XtbCalculatorBase& highLevel, const XtbCalculatorBase& lowLevel)
+  : _highLevel(highLevel), _lowLevel(lowLevel) {
+}
+
+Utils::Settings& Oniom::settings() {
+  return _settings;
+}
+
+const Utils::Settings& Oniom::settings() const {
+  return _settings;
+}
+
+const std::vector<Oniom::LinkAtom>& Oniom::getLinkAtoms() const {
+  return _linkAtoms;
+}
+
+Utils::Results Oniom::calculate(const Utils::AtomCollection& structure, const Utils::PropertyList& properties) {
+  namespace Names = OniomSettingsNames;
+  if (!_settings.valid()) {
+    _settings.throwIncorrectSettings();
+  }
+  if (!(Utils::Property::Energy | Utils::Property::Gradients).containsSubSet(properties)) {
+    throw std::runtime_error("The ONIOM calculation only provides energies and gradients.");
+  }
+  const bool gradients = properties.containsSubSet(Utils::Property::Gradients);
+  const int nAtoms = structure.size();
+
+  // Model system
+  const auto modelAtoms = _settings.getIntList(Names::modelAtoms);
+  if (modelAtoms.empty()) {
+    throw std::runtime_error("The ONIOM model system contains no atoms.");
+  }
+  std::vector<bool> inModel(nAtoms, false);
+  for (const auto atom : modelAtoms) {
+    if (atom >= nAtoms || inModel[atom]) {
+      throw std::runtime_error("The ONIOM model atoms are out of range or not unique.");
+    }
+    inModel[atom] = true;
+  }
+  _findLinkAtoms(structure, inModel);
+  const auto model = _modelSystem(structure, modelAtoms);
+
+  // Embedding charges of the environment, zero for the atoms bonded to the model system
+  const bool embedding = _settings.getBool(Names::embedding);
+  std::vector<double> charges;
+  std::vector<int> environmentAtoms;
+  std::vector<double> pointCharges;
+  if (embedding) {
+    if (!_highLevel.possibleProperties().containsSubSet(Utils::Property::PointChargesGradients)) {
+      throw std::runtime_error("The " + _highLevel.name() + " calculator does not support electrostatic embedding.");
+    }
+    charges = _settings.getDoubleList(Names::embeddingCharges);
+    if (static_cast<int>(charges.size()) != nAtoms) {
+      throw std::runtime_error("The number of ONIOM embedding charges does not match the number of atoms.");
+    }
+    for (const auto& link : _linkAtoms) {
+      charges[link.environmentAtom] = 0.0;
+    }
+    for (int atom = 0; atom < nAtoms; ++atom) {
+      if (inModel[atom] || charges[atom] == 0.0) {
+        continue;
+      }
+      const auto position = structure.getPosition(atom);
+      const auto atomicNumber = static_cast<double>(Utils::ElementInfo::Z(structure.getElement(atom)));
+      pointCharges.insert(pointCharges.end(), {charges[atom], atomicNumber, position.x(), position.y(), position.z()});
+      environmentAtoms.push_back(atom);
+    }
+  }
+
+  // The three calculations: low(real), high(model), low(model)
+  std::vector<Job> jobs(3);
+  jobs[0].calculator = &_lowLevel;
+  jobs[0].structure = structure;
+  jobs[0].charge = _lowLevel.settings().getInt(Utils::SettingsNames::molecularCharge);
+  jobs[0].multiplicity = _lowLevel.settings().getInt(Utils::SettingsNames::spinMultiplicity);
+  jobs[1].calculator = &_highLevel;
+  jobs[2].calculator = &_lowLevel;
+  for (int n = 1; n < 3; ++n) {
+    jobs[n].structure = model;
+    jobs[n].charge = _settings.getInt(Names::modelCharge);
+    jobs[n].multiplicity = _settings.getInt(Names::modelSpinMultiplicity);
+  }
+  jobs[1].pointCharges = pointCharges;
+  std::exception_ptr error = nullptr;
+#pragma omp parallel for schedule(dynamic)
+  for (int n = 0; n < 3; ++n) {
+    try {
+      auto& job = jobs[n];
+      auto calculator = job.calculator->clone();
+      auto& settings = calculator->settings();
+      settings.modifyInt(Utils::SettingsNames::externalProgramNProcs, 1);
+      settings.modifyInt(Utils::SettingsNames::molecularCharge, job.charge);
+      settings.modifyInt(Utils::SettingsNames::spinMultiplicity, job.multiplicity);
+      Utils::PropertyList required(Utils::Property::Energy);
+      if (gradients) {
+        required.addProperty(Utils::Property::Gradients);
+      }
+      if (!job.pointCharges.empty()) {
+        settings.modifyDoubleList(Utils::SettingsNames::mmCharges, job.pointCharges);
+        if (gradients) {
+          required.addProperty(Utils::Property::PointChargesGradients);
+        }
+      }
+      calculator->setStructure(job.structure);
+      calculator->setRequiredProperties(required);
+      const auto& results = calculator->calculate("");
+      job.energy = results.get<Utils::Property::Energy>();
+      if (gradients) {
+        job.gradients = results.get<Utils::Property::Gradients>();
+        if (!job.pointCharges.empty()) {
+          job.pointChargesGradients = results.get<Utils::Property::PointChargesGradients>();
+        }
+      }
+    }
+    catch (...) {
+#pragma omp critical(XtbOniomError)
+      {
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+
+  // Assemble
+  double energy = jobs[0].energy + jobs[1].energy - jobs[2].energy;
+  Utils::GradientCollection total;
+  if (gradients) {
+    total = jobs[0].gradients;
+    const Utils::GradientCollection modelGradients = jobs[1].gradients - jobs[2].gradients;
+    const int nModel = static_cast<int>(modelAtoms.size());
+    for (int k = 0; k < nModel; ++k) {
+      total.row(modelAtoms[k]) += modelGradients.row(k);
+    }
+    for (unsigned l = 0; l < _linkAtoms.size(); ++l) {
+      const auto& link = _linkAtoms[l];
+      const Utils::Position linkGradient = modelGradients.row(nModel + l);
+      total.row(link.modelAtom) += (1.0 - link.ratio) * linkGradient;
+      total.row(link.environmentAtom) += link.ratio * linkGradient;
+    }
+    for (unsigned k = 0; k < environmentAtoms.size(); ++k) {
+      total.row(environmentAtoms[k]) += jobs[1].pointChargesGradients.row(k);
+    }
+  }
+  // The Coulomb interaction of the model charges with the embedding charges belongs to E_low(model)
+  for (const auto i : modelAtoms) {
+    for (const auto j : environmentAtoms) {
+      const Utils::Position r = structure.getPosition(i) - structure.getPosition(j);
+      const double distance = r.norm();
+      energy -= charges[i] * charges[j] / distance;
+      if (gradients) {
+        const Utils::Position gradient = -charges[i] * charges[j] / (distance * distance * distance) * r;
+        total.row(i) -= gradient;
+        total.row(j) += gradient;
+      }
+    }
+  }
+
+  Utils::Results results;
+  results.set<Utils::Property::Energy>(energy);
+  if (gradients) {
+    results.set<Utils::Property::Gradients>(total);
+  }
+  results.set<Utils::Property::SuccessfulCalculation>(true);
+  return results;
+}
+
+void Oniom::_findLinkAtoms(const Utils::AtomCollection& structure, const std::vector<bool>& inModel) {
+  _linkAtoms.clear();
+  const auto bondOrders = Utils::BondDetector::detectBonds(structure);
+  const auto& matrix = bondOrders.getMatrix();
+  const double hydrogenRadius = Utils::ElementInfo::covalentRadius(Utils::ElementType::H);
+  for (int k = 0; k < matrix.outerSize(); ++k) {
+    for (Eigen::SparseMatrix<double>::InnerIterator it(matrix, k); it; ++it) {
+      const int i = it.row();
+      const int j = it.col();
+      if (it.value() < 0.5 || !inModel[i] || inModel[j]) {
+        continue;
+      }
+      // Ratio of the model atom-hydrogen and the model atom-environment atom bond lengths
+      const double modelRadius = Utils::ElementInfo::covalentRadius(structure.getElement(i));
+      const double environmentRadius = Utils::ElementInfo::covalentRadius(structure.getElement(j));
+      _linkAtoms.push_back({i, j, (modelRadius + hydrogenRadius) / (modelRadius + environmentRadius)});
+    }
+  }
+}
+
+Utils::AtomCollection Oniom::_modelSystem(const Utils::AtomCollection& structure,
+                                          const std::vector<int>& modelAtoms) const {
+  const int nModel = static_cast<int>(modelAtoms.size());
+  Utils::AtomCollection model(nModel + static_cast<int>(_linkAtoms.size()));
+  for (int k = 0; k < nModel; ++k) {
+    model.setElement(k, structure.getElement(modelAtoms[k]));
+    model.setPosition(k, structure.getPosition(modelAtoms[k]));
+  }
+  for (unsigned l = 0; l < _linkAtoms.size(); ++l) {
+    const auto& link = _linkAtoms[l];
+    const Utils::Position modelPosition = structure.getPosition(link.modelAtom);
+    const Utils::Position environmentPosition = structure.getPosition(link.environmentAtom);
+    model.setElement(nModel + l, Utils::ElementType::H);
+    model.setPosition(nModel + l, modelPosition + link.ratio * (environmentPosition - modelPosition));
+  }
+  return model;
+}
+
+} /* namespace Xtb */
+} /* namespace Scine */
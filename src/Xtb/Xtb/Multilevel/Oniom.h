@@ -0,0 +1,95 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_ONIOM_H_
+#define XTB_ONIOM_H_
+
+/* Internal Includes */
+#include "Xtb/Multilevel/OniomSettings.h"
+/* External Includes */
+#include <Utils/CalculatorBasics.h>
+#include <Utils/Geometry/AtomCollection.h>
+#include <vector>
+
+namespace Scine {
+namespace Xtb {
+
+class XtbCalculatorBase;
+
+/**
+ * @class Oniom
+ * @brief Two-layer subtractive ONIOM, e.g. GFN2 for a reactive core in GFN-FF.
+ *
+ * The energy is assembled from three calculations,
+ *   E = E_low(real) + E_high(model) - E_low(model),
+ * where the model system is capped with hydrogen link atoms placed on the
+ * broken bonds with a fixed ratio of the covalent radii. The gradients of the
+ * link atoms are distributed onto the two atoms of the broken bond.
+ *
+ * With electrostatic embedding, the high-level model calculation sees the
+ * given charges of the remaining atoms through the external charges of the
+ * calculator, and the Coulomb interaction of the model charges with them is
+ * subtracted as part of E_low(model).
+ *
+ * The three calculations are independent and are run concurrently, each with
+ * a clone of the respective calculator.
+ */
+class Oniom {
+ public:
+  /// @brief A hydrogen link atom replacing the environment atom of a broken bond.
+  struct LinkAtom {
+    int modelAtom;
+    int environmentAtom;
+    /// @brief The position of the link atom along the bond, as a fraction of the bond length.
+    double ratio;
+  };
+  /**
+   * @brief Constructor.
+   * @param highLevel The calculator of the model system, e.g. GFN2. Its
+   *                  charge and multiplicity are taken from the settings of
+   *                  this class.
+   * @param lowLevel  The calculator of the full and of the model system, e.g.
+   *                  GFN-FF. Its charge and multiplicity refer to the full system.
+   */
+  Oniom(const XtbCalculatorBase& highLevel, const XtbCalculatorBase& lowLevel);
+  /// @brief Accessor for the settings of the ONIOM calculation.
+  Utils::Settings& settings();
+  /// @brief Const accessor for the settings of the ONIOM calculation.
+  const Utils::Settings& settings() const;
+  /**
+   * @brief Calculates the ONIOM energy and gradients of the given structure.
+   * @param structure  The full structure.
+   * @param properties The required properties, energy and optionally gradients.
+   * @return Utils::Results The energy and, if required, the gradients.
+   */
+  Utils::Results calculate(const Utils::AtomCollection& structure, const Utils::PropertyList& properties);
+  /// @brief The link atoms of the last calculation.
+  const std::vector<LinkAtom>& getLinkAtoms() const;
+
+ private:
+  struct Job {
+    const XtbCalculatorBase* calculator;
+    Utils::AtomCollection structure;
+    int charge;
+    int multiplicity;
+    std::vector<double> pointCharges;
+    double energy = 0.0;
+    Utils::GradientCollection gradients;
+    Utils::GradientCollection pointChargesGradients;
+  };
+  void _findLinkAtoms(const Utils::AtomCollection& structure, const std::vector<bool>& inModel);
+  Utils::AtomCollection _modelSystem(const Utils::AtomCollection& structure, const std::vector<int>& modelAtoms) const;
+
+  const XtbCalculatorBase& _highLevel;
+  const XtbCalculatorBase& _lowLevel;
+  OniomSettings _settings;
+  std::vector<LinkAtom> _linkAtoms;
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_ONIOM_H_ */
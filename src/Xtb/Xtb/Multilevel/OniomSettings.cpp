@@ -0,0 +1,48 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Multilevel/OniomSettings.h"
+
+namespace Scine {
+namespace Xtb {
+
+OniomSettings::OniomSettings() : Scine::Utils::Settings("OniomSettings") {
+  using namespace Scine::Utils::UniversalSettings;
+  namespace Names = OniomSettingsNames;
+
+  // Model system
+  IntListDescriptor modelAtoms("The indices of the atoms of the model system, i.e. the region treated with the "
+                               "high-level method. Bonds to the remaining atoms are capped with hydrogen link atoms.");
+  modelAtoms.setItemMinimum(0);
+  this->_fields.push_back(Names::modelAtoms, modelAtoms);
+
+  IntDescriptor modelCharge("The molecular charge of the capped model system.");
+  modelCharge.setDefaultValue(0);
+  this->_fields.push_back(Names::modelCharge, modelCharge);
+
+  IntDescriptor modelSpinMultiplicity("The spin multiplicity of the capped model system.");
+  modelSpinMultiplicity.setMinimum(1);
+  modelSpinMultiplicity.setDefaultValue(1);
+  this->_fields.push_back(Names::modelSpinMultiplicity, modelSpinMultiplicity);
+
+  // Embedding
+  BoolDescriptor embedding("Whether the high-level calculation of the model system is embedded in the charges of "
+                           "the remaining atoms (ONIOM-EE). The charges of atoms bonded to the model system are "
+                           "set to zero. Requires a high-level method providing point charge gradients.");
+  embedding.setDefaultValue(false);
+  this->_fields.push_back(Names::embedding, embedding);
+
+  DoubleListDescriptor embeddingCharges("The point charge of each atom of the full system used for the "
+                                        "electrostatic embedding, e.g. from a force field.");
+  this->_fields.push_back(Names::embeddingCharges, embeddingCharges);
+
+  this->resetToDefaults();
+}
+
+} /* namespace Xtb */
+} /* namespace Scine */
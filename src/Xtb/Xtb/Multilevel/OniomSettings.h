@@ -0,0 +1,39 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_ONIOMSETTINGS_H_
+#define XTB_ONIOMSETTINGS_H_
+
+/* External Includes */
+#include <Utils/Settings.h>
+
+namespace Scine {
+namespace Xtb {
+
+namespace OniomSettingsNames {
+static constexpr const char* modelAtoms = "model_atoms";
+static constexpr const char* modelCharge = "model_charge";
+static constexpr const char* modelSpinMultiplicity = "model_spin_multiplicity";
+static constexpr const char* embedding = "electrostatic_embedding";
+static constexpr const char* embeddingCharges = "embedding_charges";
+} // namespace OniomSettingsNames
+
+/**
+ * @class OniomSettings
+ * @brief The settings of the two-layer ONIOM calculation.
+ */
+class OniomSettings : public Scine::Utils::Settings {
+ public:
+  /**
+   * @brief Construct a new OniomSettings object.
+   */
+  OniomSettings();
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_ONIOMSETTINGS_H_ */
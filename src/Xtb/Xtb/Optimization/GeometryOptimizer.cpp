@@ -0,0 +1,206 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Optimization/GeometryOptimizer.h"
+#include "Xtb/Wrapper/XtbCalculatorBase.h"
+#include "Xtb/Wrapper/XtbSession.h"
+/* External Includes */
+#include <Utils/UniversalSettings/SettingsNames.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Scine {
+namespace Xtb {
+
+namespace {
+// Steps raising the energy by more than this multiple of the SCF accuracy are rejected
+constexpr double energyNoiseFactor = 10.0;
+
+Eigen::Map<const Eigen::VectorXd> flatten(const Utils::PositionCollection& matrix) {
+  return Eigen::Map<const Eigen::VectorXd>(matrix.data(), matrix.size());
+}
+} // namespace
+
+GeometryOptimizer::GeometryOptimizer(XtbCalculatorBase& calculator) : _calculator(calculator) {
+}
+
+Utils::Settings& GeometryOptimizer::settings() {
+  return _settings;
+}
+
+const Utils::Settings& GeometryOptimizer::settings() const {
+  return _settings;
+}
+
+void GeometryOptimizer::setObserver(Observer observer) {
+  _observer = std::move(observer);
+}
+
+int GeometryOptimizer::optimize(Utils::AtomCollection& structure) {
+  namespace Names = GeometryOptimizerSettingsNames;
+  if (!_settings.valid()) {
+    _settings.throwIncorrectSettings();
+  }
+  const int maxIterations = _settings.getInt(Names::maxIterations);
+  const double gradMaxThreshold = _settings.getDouble(Names::gradMaxCoeff);
+  const double gradRmsThreshold = _settings.getDouble(Names::gradRms);
+  const double deltaValueThreshold = _settings.getDouble(Names::deltaValue);
+  const double stepMaxThreshold = _settings.getDouble(Names::stepMaxCoeff);
+  const double maxStep = _settings.getDouble(Names::maxStep);
+  const auto memory = static_cast<unsigned>(_settings.getInt(Names::memory));
+  _finalScfCriterion = _calculator.settings().getDouble(Utils::SettingsNames::selfConsistenceCriterion);
+  _history.clear();
+  _nSinglePoints = 0;
+
+  _calculator.setStructure(structure);
+  auto session = _calculator.createSession();
+  Utils::PositionCollection positions = structure.getPositions();
+  double scfCriterion = _scfCriterion(std::numeric_limits<double>::infinity());
+  session->setSelfConsistenceCriterion(scfCriterion);
+  _evaluate(*session, positions);
+
+  double trustRadius = maxStep;
+  for (int cycle = 1; cycle <= maxIterations; ++cycle) {
+    // Step along the L-BFGS direction, limited by the trust radius
+    const Eigen::VectorXd gradient = flatten(_gradients);
+    Eigen::VectorXd direction = _lbfgsDirection(gradient);
+    if (direction.dot(gradient) >= 0.0) {
+      _history.clear();
+      direction = -gradient;
+    }
+    Utils::DisplacementCollection step =
+        Eigen::Map<const Utils::DisplacementCollection>(direction.data(), positions.rows(), 3);
+    const double largestDisplacement = step.rowwise().norm().maxCoeff();
+    if (largestDisplacement > trustRadius) {
+      step *= trustRadius / largestDisplacement;
+    }
+
+    const double oldEnergy = _energy;
+    const Utils::GradientCollection oldGradients = _gradients;
+    const Utils::PositionCollection newPositions = positions + step;
+    _evaluate(*session, newPositions);
+
+    if (_energy - oldEnergy > energyNoiseFactor * scfCriterion) {
+      // Reject the step and restart the L-BFGS history
+      _energy = oldEnergy;
+      _gradients = oldGradients;
+      _history.clear();
+      trustRadius *= 0.5;
+      continue;
+    }
+    positions = newPositions;
+    trustRadius = std::min(1.2 * trustRadius, maxStep);
+    const Eigen::VectorXd s = flatten(step);
+    const Eigen::VectorXd y = flatten(_gradients) - gradient;
+    if (s.dot(y) > 1e-10) {
+      _history.emplace_back(s, y);
+      if (_history.size() > memory) {
+        _history.pop_front();
+      }
+    }
+    if (_observer) {
+      _observer(cycle, _energy, positions);
+    }
+
+    // Convergence check
+    const double gradMax = _gradients.cwiseAbs().maxCoeff();
+    const double gradRms = std::sqrt(_gradients.squaredNorm() / _gradients.size());
+    const bool converged = gradMax < gradMaxThreshold && gradRms < gradRmsThreshold &&
+                           (std::abs(_energy - oldEnergy) < deltaValueThreshold ||
+                            step.cwiseAbs().maxCoeff() < stepMaxThreshold);
+    if (converged && scfCriterion > _finalScfCriterion) {
+      // Confirm the convergence with the final SCF accuracy
+      scfCriterion = _finalScfCriterion;
+      session->setSelfConsistenceCriterion(scfCriterion);
+      _evaluate(*session, positions);
+      if (_gradients.cwiseAbs().maxCoeff() < gradMaxThreshold &&
+          std::sqrt(_gradients.squaredNorm() / _gradients.size()) < gradRmsThreshold) {
+        structure.setPositions(positions);
+        _calculator.modifyPositions(positions);
+        return cycle;
+      }
+      _history.clear();
+    }
+    else if (converged) {
+      structure.setPositions(positions);
+      _calculator.modifyPositions(positions);
+      return cycle;
+    }
+    else {
+      // Tighten the SCF accuracy as the gradient decreases
+      const double newScfCriterion = _scfCriterion(gradMax);
+      if (newScfCriterion < scfCriterion) {
+        scfCriterion = newScfCriterion;
+        session->setSelfConsistenceCriterion(scfCriterion);
+      }
+    }
+  }
+  structure.setPositions(positions);
+  _calculator.modifyPositions(positions);
+  throw std::runtime_error("The geometry optimization did not converge within " + std::to_string(maxIterations) +
+                           " cycles.");
+}
+
+double GeometryOptimizer::getEnergy() const {
+  return _energy;
+}
+
+const Utils::GradientCollection& GeometryOptimizer::getGradients() const {
+  return _gradients;
+}
+
+int GeometryOptimizer::getNumberOfSinglePoints() const {
+  return _nSinglePoints;
+}
+
+void GeometryOptimizer::_evaluate(XtbSession& session, const Utils::PositionCollection& positions) {
+  session.updatePositions(positions);
+  session.singlepoint();
+  _energy = session.getEnergy();
+  _gradients.resize(positions.rows(), 3);
+  session.getGradients(_gradients.data());
+  ++_nSinglePoints;
+}
+
+Eigen::VectorXd GeometryOptimizer::_lbfgsDirection(const Eigen::VectorXd& gradient) const {
+  // L-BFGS two-loop recursion
+  Eigen::VectorXd q = gradient;
+  std::vector<double> alpha(_history.size());
+  for (int i = static_cast<int>(_history.size()) - 1; i >= 0; --i) {
+    const auto& s = _history[i].first;
+    const auto& y = _history[i].second;
+    alpha[i] = s.dot(q) / y.dot(s);
+    q -= alpha[i] * y;
+  }
+  if (!_history.empty()) {
+    const auto& s = _history.back().first;
+    const auto& y = _history.back().second;
+    q *= s.dot(y) / y.squaredNorm();
+  }
+  for (unsigned i = 0; i < _history.size(); ++i) {
+    const auto& s = _history[i].first;
+    const auto& y = _history[i].second;
+    const double beta = y.dot(q) / y.dot(s);
+    q += (alpha[i] - beta) * s;
+  }
+  return -q;
+}
+
+double GeometryOptimizer::_scfCriterion(double gradMax) const {
+  const double factor = _settings.getDouble(GeometryOptimizerSettingsNames::scfCriterionFactor);
+  if (factor == 0.0) {
+    return _finalScfCriterion;
+  }
+  const double initial = std::max(_settings.getDouble(GeometryOptimizerSettingsNames::initialScfCriterion),
+                                  _finalScfCriterion);
+  return std::max(_finalScfCriterion, std::min(initial, factor * gradMax));
+}
+
+} /* namespace Xtb */
+} /* namespace Scine */
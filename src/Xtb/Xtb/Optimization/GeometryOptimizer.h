@@ -0,0 +1,94 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_GEOMETRYOPTIMIZER_H_
+#define XTB_GEOMETRYOPTIMIZER_H_
+
+/* Internal Includes */
+#include "Xtb/Optimization/GeometryOptimizerSettings.h"
+/* External Includes */
+#include <Utils/Geometry/AtomCollection.h>
+#include <Utils/Typenames.h>
+#include <deque>
+#include <functional>
+
+namespace Scine {
+namespace Xtb {
+
+class XtbCalculatorBase;
+class XtbSession;
+
+/**
+ * @class GeometryOptimizer
+ * @brief Cartesian L-BFGS geometry optimization on top of a single xtb session.
+ *
+ * The parametrized calculator and the wavefunction are kept for the whole
+ * optimization, each cycle restarts the SCF from the density of the previous
+ * geometry. The SCF accuracy is adapted to the progress of the optimization:
+ * far from the minimum a loose accuracy is sufficient, it is tightened as the
+ * gradient decreases and convergence is only signaled with the accuracy
+ * requested in the settings of the calculator.
+ */
+class GeometryOptimizer {
+ public:
+  /**
+   * @brief The observer is called after each accepted cycle with the cycle
+   *        number, the energy and the positions.
+   */
+  using Observer = std::function<void(int, double, const Utils::PositionCollection&)>;
+  /**
+   * @brief Constructor.
+   * @param calculator The calculator defining the method and its settings.
+   */
+  explicit GeometryOptimizer(XtbCalculatorBase& calculator);
+  /// @brief Accessor for the settings of the optimizer.
+  Utils::Settings& settings();
+  /// @brief Const accessor for the settings of the optimizer.
+  const Utils::Settings& settings() const;
+  /**
+   * @brief Sets the observer of the optimization.
+   * @param observer The observer.
+   */
+  void setObserver(Observer observer);
+  /**
+   * @brief Optimizes the given structure.
+   *
+   * The structure is set in the calculator, at the end of the optimization the
+   * positions of the calculator and of the given structure are updated to the
+   * optimized positions.
+   *
+   * @param structure The structure to be optimized.
+   * @throws std::runtime_error If the optimization did not converge within the
+   *         maximum number of cycles.
+   * @return int The number of optimization cycles.
+   */
+  int optimize(Utils::AtomCollection& structure);
+  /// @brief The energy of the last accepted geometry.
+  double getEnergy() const;
+  /// @brief The gradients of the last accepted geometry.
+  const Utils::GradientCollection& getGradients() const;
+  /// @brief The number of single points of the last optimization.
+  int getNumberOfSinglePoints() const;
+
+ private:
+  void _evaluate(XtbSession& session, const Utils::PositionCollection& positions);
+  Eigen::VectorXd _lbfgsDirection(const Eigen::VectorXd& gradient) const;
+  double _scfCriterion(double gradMax) const;
+
+  XtbCalculatorBase& _calculator;
+  GeometryOptimizerSettings _settings;
+  Observer _observer;
+  std::deque<std::pair<Eigen::VectorXd, Eigen::VectorXd>> _history;
+  Utils::GradientCollection _gradients;
+  double _energy = 0.0;
+  double _finalScfCriterion = 0.0;
+  int _nSinglePoints = 0;
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_GEOMETRYOPTIMIZER_H_ */
@@ -0,0 +1,75 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Optimization/GeometryOptimizerSettings.h"
+
+namespace Scine {
+namespace Xtb {
+
+GeometryOptimizerSettings::GeometryOptimizerSettings() : Scine::Utils::Settings("GeometryOptimizerSettings") {
+  using namespace Scine::Utils::UniversalSettings;
+  namespace Names = GeometryOptimizerSettingsNames;
+
+  // Maximum number of iterations
+  IntDescriptor maxIterations("The maximum number of optimization cycles.");
+  maxIterations.setMinimum(0);
+  maxIterations.setDefaultValue(500);
+  this->_fields.push_back(Names::maxIterations, maxIterations);
+
+  // Convergence criteria
+  DoubleDescriptor gradMaxCoeff("The threshold for the largest gradient component in hartree/bohr.");
+  gradMaxCoeff.setMinimum(0.0);
+  gradMaxCoeff.setDefaultValue(5e-4);
+  this->_fields.push_back(Names::gradMaxCoeff, gradMaxCoeff);
+
+  DoubleDescriptor gradRms("The threshold for the root mean square of the gradient in hartree/bohr.");
+  gradRms.setMinimum(0.0);
+  gradRms.setDefaultValue(1e-4);
+  this->_fields.push_back(Names::gradRms, gradRms);
+
+  DoubleDescriptor deltaValue("The threshold for the energy change between two cycles in hartree.");
+  deltaValue.setMinimum(0.0);
+  deltaValue.setDefaultValue(1e-7);
+  this->_fields.push_back(Names::deltaValue, deltaValue);
+
+  DoubleDescriptor stepMaxCoeff("The threshold for the largest step component in bohr.");
+  stepMaxCoeff.setMinimum(0.0);
+  stepMaxCoeff.setDefaultValue(2e-3);
+  this->_fields.push_back(Names::stepMaxCoeff, stepMaxCoeff);
+
+  // L-BFGS
+  IntDescriptor memory("The number of steps kept in the L-BFGS history.");
+  memory.setMinimum(1);
+  memory.setDefaultValue(20);
+  this->_fields.push_back(Names::memory, memory);
+
+  DoubleDescriptor maxStep("The largest displacement of a single atom in one step in bohr.");
+  maxStep.setMinimum(0.0);
+  maxStep.setDefaultValue(0.3);
+  this->_fields.push_back(Names::maxStep, maxStep);
+
+  // Adaptive SCF accuracy
+  DoubleDescriptor initialScfCriterion("The SCF energy accuracy in hartree used for the first cycles. The accuracy "
+                                       "is tightened towards the self_consistence_criterion of the calculator as "
+                                       "the gradient decreases.");
+  initialScfCriterion.setMinimum(0.0);
+  initialScfCriterion.setDefaultValue(1e-5);
+  this->_fields.push_back(Names::initialScfCriterion, initialScfCriterion);
+
+  DoubleDescriptor scfCriterionFactor("The SCF energy accuracy of a cycle is this factor times the largest "
+                                      "gradient component, bounded by the initial and the final accuracy. A "
+                                      "factor of zero disables the adaptive accuracy.");
+  scfCriterionFactor.setMinimum(0.0);
+  scfCriterionFactor.setDefaultValue(1e-3);
+  this->_fields.push_back(Names::scfCriterionFactor, scfCriterionFactor);
+
+  this->resetToDefaults();
+}
+
+} /* namespace Xtb */
+} /* namespace Scine */
@@ -0,0 +1,43 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_GEOMETRYOPTIMIZERSETTINGS_H_
+#define XTB_GEOMETRYOPTIMIZERSETTINGS_H_
+
+/* External Includes */
+#include <Utils/Settings.h>
+
+namespace Scine {
+namespace Xtb {
+
+namespace GeometryOptimizerSettingsNames {
+static constexpr const char* maxIterations = "convergence_max_iterations";
+static constexpr const char* gradMaxCoeff = "convergence_grad_max_coeff";
+static constexpr const char* gradRms = "convergence_grad_rms";
+static constexpr const char* deltaValue = "convergence_delta_value";
+static constexpr const char* stepMaxCoeff = "convergence_step_max_coeff";
+static constexpr const char* memory = "lbfgs_memory";
+static constexpr const char* maxStep = "lbfgs_max_step";
+static constexpr const char* initialScfCriterion = "initial_self_consistence_criterion";
+static constexpr const char* scfCriterionFactor = "self_consistence_criterion_factor";
+} // namespace GeometryOptimizerSettingsNames
+
+/**
+ * @class GeometryOptimizerSettings
+ * @brief The settings of the xtb geometry optimizer.
+ */
+class GeometryOptimizerSettings : public Scine::Utils::Settings {
+ public:
+  /**
+   * @brief Construct a new GeometryOptimizerSettings object.
+   */
+  GeometryOptimizerSettings();
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_GEOMETRYOPTIMIZERSETTINGS_H_ */
@@ -0,0 +1,394 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/ProcessPool/ProcessPool.h"
+#include "Xtb/Wrapper/XtbCalculatorBase.h"
+#include "Xtb/Wrapper/XtbSession.h"
+/* External Includes */
+#include <Utils/Geometry/ElementInfo.h>
+#include <Utils/UniversalSettings/SettingsNames.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+namespace Scine {
+namespace Xtb {
+
+namespace {
+// The states of a slot, a running job is marked with the index of its worker
+constexpr std::uint32_t freeSlot = 0;
+constexpr std::uint32_t queuedJob = 1;
+constexpr std::uint32_t doneJob = 2;
+constexpr std::uint32_t failedJob = 3;
+constexpr std::uint32_t runningJob = 4;
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free,
+              "The shared memory queue requires lock-free atomics, which work across processes.");
+
+constexpr std::size_t align(std::size_t size) {
+  return (size + 63) / 64 * 64;
+}
+
+// Waiting with a growing sleep keeps idle workers and the waiting parent off the cores
+class Backoff {
+ public:
+  void reset() {
+    _wait = std::chrono::microseconds(20);
+  }
+  void wait() {
+    std::this_thread::sleep_for(_wait);
+    _wait = std::min(2 * _wait, std::chrono::microseconds(2000));
+  }
+
+ private:
+  std::chrono::microseconds _wait{20};
+};
+} // namespace
+
+struct ProcessPool::Header {
+  std::atomic<std::uint32_t> shutdown{0};
+  // The slot the workers start looking for queued jobs at, which keeps the queue roughly in order
+  std::atomic<std::uint32_t> dispatch{0};
+};
+
+struct ProcessPool::Slot {
+  std::atomic<std::uint32_t> state{freeSlot};
+  std::uint32_t nAtoms = 0;
+  std::uint32_t attempts = 0;
+  double energy = 0.0;
+  char error[512] = {};
+};
+
+ProcessPool::ProcessPool(const XtbCalculatorBase& calculator) : _calculator(calculator.clone()) {
+}
+
+ProcessPool::~ProcessPool() {
+  _stop();
+}
+
+Utils::Settings& ProcessPool::settings() {
+  return _settings;
+}
+
+const Utils::Settings& ProcessPool::settings() const {
+  return _settings;
+}
+
+int ProcessPool::restarts() const {
+  return _restarts;
+}
+
+void ProcessPool::start() {
+  namespace Names = ProcessPoolSettingsNames;
+  if (_memory) {
+    return;
+  }
+  if (!_settings.valid()) {
+    _settings.throwIncorrectSettings();
+  }
+  _capacity = _settings.getInt(Names::queueCapacity);
+  _maxAtoms = _settings.getInt(Names::maxAtoms);
+  const auto required = _calculator->getRequiredProperties();
+  _gradientsRequired = required.containsSubSet(Utils::Property::Gradients);
+  _chargesRequired = required.containsSubSet(Utils::Property::AtomicCharges) &&
+                     _calculator->possibleProperties().containsSubSet(Utils::Property::AtomicCharges);
+  _calculator->settings().modifyInt(Utils::SettingsNames::externalProgramNProcs,
+                                    _settings.getInt(Names::threadsPerWorker));
+
+  // Slot header, elements, positions, gradients and charges
+  _slotSize = align(sizeof(Slot)) + align(sizeof(std::uint16_t) * _maxAtoms) + align(sizeof(double) * 3 * _maxAtoms) +
+              align(sizeof(double) * 3 * _maxAtoms) + align(sizeof(double) * _maxAtoms);
+  _memorySize = align(sizeof(Header)) + _capacity * _slotSize;
+  void* memory = ::mmap(nullptr, _memorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) {
+    throw std::runtime_error(std::string("Could not map the shared memory of the process pool: ") +
+                             std::strerror(errno));
+  }
+  _memory = memory;
+  new (_memory) Header();
+  for (int i = 0; i < _capacity; ++i) {
+    new (&_slot(i)) Slot();
+  }
+  _workers.assign(_settings.getInt(Names::workers), -1);
+  try {
+    for (int w = 0; w < static_cast<int>(_workers.size()); ++w) {
+      _spawn(w);
+    }
+  }
+  catch (...) {
+    _stop();
+    throw;
+  }
+}
+
+ProcessPool::Slot& ProcessPool::_slot(int index) const {
+  return *reinterpret_cast<Slot*>(static_cast<char*>(_memory) + align(sizeof(Header)) + index * _slotSize);
+}
+
+std::uint16_t* ProcessPool::_elements(Slot& slot) const {
+  return reinterpret_cast<std::uint16_t*>(reinterpret_cast<char*>(&slot) + align(sizeof(Slot)));
+}
+
+double* ProcessPool::_positions(Slot& slot) const {
+  return reinterpret_cast<double*>(reinterpret_cast<char*>(_elements(slot)) + align(sizeof(std::uint16_t) * _maxAtoms));
+}
+
+double* ProcessPool::_gradients(Slot& slot) const {
+  return reinterpret_cast<double*>(reinterpret_cast<char*>(_positions(slot)) + align(sizeof(double) * 3 * _maxAtoms));
+}
+
+double* ProcessPool::_charges(Slot& slot) const {
+  return reinterpret_cast<double*>(reinterpret_cast<char*>(_gradients(slot)) + align(sizeof(double) * 3 * _maxAtoms));
+}
+
+void ProcessPool::_spawn(int worker) {
+  // Buffered output would otherwise be written by both processes
+  std::cout.flush();
+  std::cerr.flush();
+  std::fflush(nullptr);
+  const pid_t pid = ::fork();
+  if (pid < 0) {
+    throw std::runtime_error(std::string("Could not fork a worker of the process pool: ") + std::strerror(errno));
+  }
+  if (pid == 0) {
+    _work(worker);
+  }
+  _workers[worker] = pid;
+}
+
+void ProcessPool::_work(int worker) {
+  int status = 0;
+  try {
+    auto& header = *static_cast<Header*>(_memory);
+    const pid_t parent = ::getppid();
+    const std::uint32_t running = runningJob + worker;
+    auto calculator = _calculator->clone();
+    std::unique_ptr<XtbSession> session;
+    Utils::ElementTypeCollection elements;
+    Backoff backoff;
+    // Workers whose parent died are adopted, they stop as well
+    while (header.shutdown.load() == 0 && ::getppid() == parent) {
+      bool found = false;
+      const std::uint32_t start = header.dispatch.load();
+      for (int i = 0; i < _capacity && !found; ++i) {
+        const int index = (start + i) % _capacity;
+        auto& slot = _slot(index);
+        std::uint32_t expected = queuedJob;
+        if (slot.state.compare_exchange_strong(expected, running)) {
+          header.dispatch.store((index + 1) % _capacity);
+          _runJob(slot, *calculator, session, elements);
+          found = true;
+        }
+      }
+      if (found) {
+        backoff.reset();
+      }
+      else {
+        backoff.wait();
+      }
+    }
+  }
+  catch (...) {
+    status = 1;
+  }
+  // Neither the destructors nor the exit handlers of the parent may run in the worker
+  ::_exit(status);
+}
+
+void ProcessPool::_runJob(Slot& slot, XtbCalculatorBase& calculator, std::unique_ptr<XtbSession>& session,
+                          Utils::ElementTypeCollection& elements) {
+  try {
+    const int nAtoms = slot.nAtoms;
+    const std::uint16_t* numbers = _elements(slot);
+    Utils::ElementTypeCollection jobElements(nAtoms);
+    for (int i = 0; i < nAtoms; ++i) {
+      jobElements[i] = Utils::ElementInfo::element(numbers[i]);
+    }
+    const Utils::PositionCollection positions =
+        Eigen::Map<const Utils::PositionCollection>(_positions(slot), nAtoms, 3);
+    if (!session || jobElements != elements) {
+      session.reset();
+      elements = std::move(jobElements);
+      calculator.setStructure(Utils::AtomCollection(elements, positions));
+      session = calculator.createSession();
+    }
+    else {
+      calculator.modifyPositions(positions);
+    }
+    XtbOutputBuffers buffers;
+    buffers.energy = &slot.energy;
+    if (_gradientsRequired) {
+      buffers.gradients = _gradients(slot);
+    }
+    if (_chargesRequired) {
+      buffers.atomicCharges = _charges(slot);
+    }
+    calculator.calculate(*session, buffers);
+    slot.state.store(doneJob);
+  }
+  catch (const std::exception& e) {
+    // The session may be left in any state
+    session.reset();
+    std::strncpy(slot.error, e.what(), sizeof(slot.error) - 1);
+    slot.state.store(failedJob);
+  }
+}
+
+std::vector<ProcessPool::Result> ProcessPool::evaluate(const std::vector<Utils::AtomCollection>& structures) {
+  start();
+  // The slots are sized when the pool starts, later changes of max_atoms do not apply
+  for (const auto& structure : structures) {
+    if (structure.size() > _maxAtoms) {
+      throw std::invalid_argument("A structure of " + std::to_string(structure.size()) +
+                                  " atoms exceeds the max_atoms of the process pool.");
+    }
+  }
+  const int nJobs = structures.size();
+  std::vector<Result> results(nJobs);
+  // The job in each slot, only known to the parent
+  std::vector<int> jobs(_capacity, -1);
+  int next = 0;
+  int finished = 0;
+  int cursor = 0;
+  Backoff backoff;
+  try {
+    while (finished < nJobs) {
+      bool progress = _replaceCrashedWorkers();
+      for (int s = 0; s < _capacity; ++s) {
+        if (jobs[s] < 0) {
+          continue;
+        }
+        auto& slot = _slot(s);
+        const std::uint32_t state = slot.state.load();
+        if (state != doneJob && state != failedJob) {
+          continue;
+        }
+        auto& result = results[jobs[s]];
+        const int nAtoms = slot.nAtoms;
+        result.attempts = slot.attempts;
+        result.success = state == doneJob;
+        if (result.success) {
+          result.energy = slot.energy;
+          if (_gradientsRequired) {
+            result.gradients = Eigen::Map<const Utils::GradientCollection>(_gradients(slot), nAtoms, 3);
+          }
+          if (_chargesRequired) {
+            result.atomicCharges.assign(_charges(slot), _charges(slot) + nAtoms);
+          }
+        }
+        else {
+          result.error = slot.error;
+        }
+        jobs[s] = -1;
+        slot.state.store(freeSlot);
+        ++finished;
+        progress = true;
+      }
+      for (int i = 0; i < _capacity && next < nJobs; ++i, cursor = (cursor + 1) % _capacity) {
+        if (jobs[cursor] >= 0) {
+          continue;
+        }
+        auto& slot = _slot(cursor);
+        const auto& structure = structures[next];
+        slot.nAtoms = structure.size();
+        slot.attempts = 1;
+        slot.energy = 0.0;
+        slot.error[0] = '\0';
+        std::uint16_t* numbers = _elements(slot);
+        for (int a = 0; a < structure.size(); ++a) {
+          numbers[a] = static_cast<std::uint16_t>(Utils::ElementInfo::Z(structure.getElement(a)));
+        }
+        std::copy_n(structure.getPositions().data(), 3 * structure.size(), _positions(slot));
+        jobs[cursor] = next++;
+        slot.state.store(queuedJob);
+        progress = true;
+      }
+      if (progress) {
+        backoff.reset();
+      }
+      else {
+        backoff.wait();
+      }
+    }
+  }
+  catch (...) {
+    // The queue no longer matches the jobs, start over with new workers
+    _stop();
+    throw;
+  }
+  return results;
+}
+
+bool ProcessPool::_replaceCrashedWorkers() {
+  const int maxAttempts = _settings.getInt(ProcessPoolSettingsNames::maxAttempts);
+  bool crashed = false;
+  for (int w = 0; w < static_cast<int>(_workers.size()); ++w) {
+    int status = 0;
+    if (::waitpid(_workers[w], &status, WNOHANG) != _workers[w]) {
+      continue;
+    }
+    crashed = true;
+    const std::string reason = WIFSIGNALED(status) ? "signal " + std::to_string(WTERMSIG(status))
+                                                   : "exit code " + std::to_string(WEXITSTATUS(status));
+    // The worker is gone, so its jobs cannot change anymore
+    bool hadJob = false;
+    for (int s = 0; s < _capacity; ++s) {
+      auto& slot = _slot(s);
+      if (slot.state.load() != runningJob + w) {
+        continue;
+      }
+      hadJob = true;
+      if (static_cast<int>(slot.attempts) >= maxAttempts) {
+        const std::string error = "The worker crashed on this job (" + reason + ").";
+        std::strncpy(slot.error, error.c_str(), sizeof(slot.error) - 1);
+        slot.state.store(failedJob);
+      }
+      else {
+        ++slot.attempts;
+        slot.state.store(queuedJob);
+      }
+    }
+    // A worker dying without a job would do so again after every restart
+    if (!hadJob) {
+      _workers[w] = -1;
+      throw std::runtime_error("A worker of the process pool stopped without a job (" + reason + ").");
+    }
+    _spawn(w);
+    ++_restarts;
+  }
+  return crashed;
+}
+
+void ProcessPool::_stop() {
+  if (!_memory) {
+    return;
+  }
+  static_cast<Header*>(_memory)->shutdown.store(1);
+  for (const pid_t pid : _workers) {
+    if (pid <= 0) {
+      continue;
+    }
+    while (::waitpid(pid, nullptr, 0) < 0 && errno == EINTR) {
+    }
+  }
+  _workers.clear();
+  ::munmap(_memory, _memorySize);
+  _memory = nullptr;
+}
+
+} /* namespace Xtb */
+} /* namespace Scine */
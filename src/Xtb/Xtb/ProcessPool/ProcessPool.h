@@ -0,0 +1,116 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_PROCESSPOOL_H_
+#define XTB_PROCESSPOOL_H_
+
+/* Internal Includes */
+#include "Xtb/ProcessPool/ProcessPoolSettings.h"
+/* External Includes */
+#include <Utils/Geometry/AtomCollection.h>
+#include <Utils/Typenames.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+namespace Scine {
+namespace Xtb {
+
+class XtbCalculatorBase;
+class XtbSession;
+
+/**
+ * @class ProcessPool
+ * @brief Evaluates structures in forked worker processes, which isolates the
+ *        global state of xtb and survives crashing workers.
+ *
+ * The jobs are exchanged through a ring of fixed-size slots in anonymous
+ * shared memory mapped before the workers are forked. A slot holds the
+ * elements and positions of a job, and the worker writes the energy, the
+ * gradients and the atomic charges directly into it, so nothing is
+ * serialized. The slots are claimed with atomic compare-and-swap operations
+ * that record the claiming worker. No lock is shared with the workers, so a
+ * crashing worker cannot block the pool: the parent notices it when waiting,
+ * returns its running job to the queue and forks a replacement.
+ *
+ * Each worker clones the given calculator and keeps its session while the
+ * elements of consecutive jobs agree. The energy, the gradients and the
+ * atomic charges among the required properties of the calculator are
+ * returned. The parent should not run OpenMP calculations itself, since the
+ * replacement workers are forked from it.
+ */
+class ProcessPool {
+ public:
+  /// @brief The outcome of one structure.
+  struct Result {
+    bool success = false;
+    std::string error;
+    /// @brief How often the job was started, more than once if a worker crashed on it.
+    int attempts = 0;
+    double energy = 0.0;
+    Utils::GradientCollection gradients;
+    std::vector<double> atomicCharges;
+  };
+  /**
+   * @brief Constructor.
+   * @param calculator The calculator with the settings and required properties of all jobs.
+   */
+  explicit ProcessPool(const XtbCalculatorBase& calculator);
+  /// @brief Lets the workers finish their jobs and stops them.
+  ~ProcessPool();
+  ProcessPool(const ProcessPool&) = delete;
+  ProcessPool& operator=(const ProcessPool&) = delete;
+  /// @brief Accessor for the settings of the pool, to be modified before start().
+  Utils::Settings& settings();
+  /// @brief Const accessor for the settings of the pool.
+  const Utils::Settings& settings() const;
+  /// @brief Maps the shared memory and forks the workers, called by evaluate() if required.
+  void start();
+  /**
+   * @brief Evaluates the structures in the workers.
+   * @param structures The structures, at most max_atoms (as set when the pool started) atoms each.
+   * @return std::vector<Result> The results in the order of the structures.
+   */
+  std::vector<Result> evaluate(const std::vector<Utils::AtomCollection>& structures);
+  /// @brief The number of workers forked to replace crashed ones.
+  int restarts() const;
+
+ private:
+  struct Header;
+  struct Slot;
+  Slot& _slot(int index) const;
+  std::uint16_t* _elements(Slot& slot) const;
+  double* _positions(Slot& slot) const;
+  double* _gradients(Slot& slot) const;
+  double* _charges(Slot& slot) const;
+  void _spawn(int worker);
+  [[noreturn]] void _work(int worker);
+  void _runJob(Slot& slot, XtbCalculatorBase& calculator, std::unique_ptr<XtbSession>& session,
+               Utils::ElementTypeCollection& elements);
+  // Requeues the jobs of crashed workers and replaces them, returns whether any worker crashed
+  bool _replaceCrashedWorkers();
+  void _stop();
+
+  std::shared_ptr<XtbCalculatorBase> _calculator;
+  ProcessPoolSettings _settings;
+  void* _memory = nullptr;
+  std::size_t _memorySize = 0;
+  std::size_t _slotSize = 0;
+  int _capacity = 0;
+  int _maxAtoms = 0;
+  bool _gradientsRequired = false;
+  bool _chargesRequired = false;
+  std::vector<pid_t> _workers;
+  int _restarts = 0;
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_PROCESSPOOL_H_ */
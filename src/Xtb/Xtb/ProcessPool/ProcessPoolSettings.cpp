@@ -0,0 +1,49 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/ProcessPool/ProcessPoolSettings.h"
+
+namespace Scine {
+namespace Xtb {
+
+ProcessPoolSettings::ProcessPoolSettings() : Scine::Utils::Settings("ProcessPoolSettings") {
+  using namespace Scine::Utils::UniversalSettings;
+  namespace Names = ProcessPoolSettingsNames;
+
+  // Workers
+  IntDescriptor workers("The number of worker processes.");
+  workers.setMinimum(1);
+  workers.setDefaultValue(2);
+  this->_fields.push_back(Names::workers, workers);
+
+  IntDescriptor threadsPerWorker("The number of OpenMP threads of each worker process (externalProgramNProcs).");
+  threadsPerWorker.setMinimum(1);
+  threadsPerWorker.setDefaultValue(1);
+  this->_fields.push_back(Names::threadsPerWorker, threadsPerWorker);
+
+  // Queue
+  IntDescriptor queueCapacity("The number of jobs the shared memory ring holds at once.");
+  queueCapacity.setMinimum(1);
+  queueCapacity.setDefaultValue(64);
+  this->_fields.push_back(Names::queueCapacity, queueCapacity);
+
+  IntDescriptor maxAtoms("The largest structure in atoms, which determines the size of each slot of the ring.");
+  maxAtoms.setMinimum(1);
+  maxAtoms.setDefaultValue(1000);
+  this->_fields.push_back(Names::maxAtoms, maxAtoms);
+
+  IntDescriptor maxAttempts("How often a job is started before it is reported as failed, if its workers crash.");
+  maxAttempts.setMinimum(1);
+  maxAttempts.setDefaultValue(2);
+  this->_fields.push_back(Names::maxAttempts, maxAttempts);
+
+  this->resetToDefaults();
+}
+
+} /* namespace Xtb */
+} /* namespace Scine */
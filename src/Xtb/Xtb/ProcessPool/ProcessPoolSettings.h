@@ -0,0 +1,39 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_PROCESSPOOLSETTINGS_H_
+#define XTB_PROCESSPOOLSETTINGS_H_
+
+/* External Includes */
+#include <Utils/Settings.h>
+
+namespace Scine {
+namespace Xtb {
+
+namespace ProcessPoolSettingsNames {
+static constexpr const char* workers = "workers";
+static constexpr const char* threadsPerWorker = "threads_per_worker";
+static constexpr const char* queueCapacity = "queue_capacity";
+static constexpr const char* maxAtoms = "max_atoms";
+static constexpr const char* maxAttempts = "max_attempts";
+} // namespace ProcessPoolSettingsNames
+
+/**
+ * @class ProcessPoolSettings
+ * @brief The settings of the process pool.
+ */
+class ProcessPoolSettings : public Scine::Utils::Settings {
+ public:
+  /**
+   * @brief Construct a new ProcessPoolSettings object.
+   */
+  ProcessPoolSettings();
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_PROCESSPOOLSETTINGS_H_ */
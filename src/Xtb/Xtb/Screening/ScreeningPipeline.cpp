@@ -0,0 +1,209 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Screening/ScreeningPipeline.h"
+#include "Xtb/Wrapper/XtbCalculatorBase.h"
+/* External Includes */
+#include <Utils/UniversalSettings/SettingsNames.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace Scine {
+namespace Xtb {
+
+ScreeningPipeline::ScreeningPipeline(std::vector<std::shared_ptr<XtbCalculatorBase>> stages)
+  : _stages(std::move(stages)) {
+  if (_stages.empty()) {
+    throw std::invalid_argument("The screening pipeline needs at least one stage.");
+  }
+}
+
+Utils::Settings& ScreeningPipeline::settings() {
+  return _settings;
+}
+
+const Utils::Settings& ScreeningPipeline::settings() const {
+  return _settings;
+}
+
+ScreeningPipeline::Result ScreeningPipeline::screen(const std::vector<Utils::AtomCollection>& ensemble) {
+  namespace Names = ScreeningPipelineSettingsNames;
+  if (!_settings.valid()) {
+    _settings.throwIncorrectSettings();
+  }
+  for (const auto& key : {Names::keepFractions, Names::energyWindows}) {
+    const auto values = _settings.getDoubleList(key);
+    if (!values.empty() && values.size() != _stages.size()) {
+      throw std::runtime_error(std::string("The number of ") + key + " does not match the number of stages.");
+    }
+  }
+
+  Result result;
+  std::vector<int> candidates(ensemble.size());
+  std::iota(candidates.begin(), candidates.end(), 0);
+  std::vector<double> energies;
+  for (unsigned stage = 0; stage < _stages.size(); ++stage) {
+    const auto start = std::chrono::steady_clock::now();
+    energies = _evaluate(*_stages[stage], ensemble, candidates);
+    const auto selected = _select(ensemble, candidates, energies, stage);
+
+    StageReport report;
+    report.method = _stages[stage]->method();
+    report.nEvaluated = candidates.size();
+    report.nFailed = std::count_if(energies.begin(), energies.end(), [](double e) { return !std::isfinite(e); });
+    report.nKept = selected.size();
+    // The selection refers to positions within the candidates of this stage
+    std::vector<int> survivors;
+    std::vector<double> survivorEnergies;
+    for (const int n : selected) {
+      survivors.push_back(candidates[n]);
+      survivorEnergies.push_back(energies[n]);
+    }
+    candidates = std::move(survivors);
+    energies = std::move(survivorEnergies);
+    report.wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.stages.push_back(report);
+  }
+
+  // Sort by the energy of the last stage
+  std::vector<int> order(candidates.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](int a, int b) { return energies[a] < energies[b]; });
+  for (const int n : order) {
+    result.indices.push_back(candidates[n]);
+    result.energies.push_back(energies[n]);
+  }
+  return result;
+}
+
+std::vector<double> ScreeningPipeline::_evaluate(const XtbCalculatorBase& calculator,
+                                                 const std::vector<Utils::AtomCollection>& ensemble,
+                                                 const std::vector<int>& candidates) const {
+  const bool reuseSessions = _settings.getBool(ScreeningPipelineSettingsNames::reuseSessions);
+  std::vector<double> energies(candidates.size(), std::numeric_limits<double>::infinity());
+#pragma omp parallel
+  {
+    // One calculator and session per thread, the session is kept for consecutive structures
+    std::shared_ptr<XtbCalculatorBase> threadCalculator;
+    std::unique_ptr<XtbSession> session;
+#pragma omp for schedule(dynamic)
+    for (int n = 0; n < static_cast<int>(candidates.size()); ++n) {
+      const auto& structure = ensemble[candidates[n]];
+      // No exception may leave the parallel region, also not one of the setup of the calculator
+      try {
+        if (!threadCalculator) {
+          auto clone = calculator.clone();
+          clone->settings().modifyInt(Utils::SettingsNames::externalProgramNProcs, 1);
+          clone->setRequiredProperties(Utils::Property::Energy);
+          threadCalculator = std::move(clone);
+        }
+        if (reuseSessions && session && threadCalculator->getStructure()->getElements() == structure.getElements()) {
+          threadCalculator->modifyPositions(structure.getPositions());
+        }
+        else {
+          session.reset();
+          threadCalculator->setStructure(structure);
+          session = threadCalculator->createSession();
+        }
+        energies[n] = threadCalculator->calculate(*session).get<Utils::Property::Energy>();
+      }
+      catch (...) {
+        // Failed structures are dropped from the screening
+        session.reset();
+      }
+    }
+  }
+  return energies;
+}
+
+std::vector<int> ScreeningPipeline::_select(const std::vector<Utils::AtomCollection>& ensemble,
+                                            const std::vector<int>& candidates, const std::vector<double>& energies,
+                                            int stage) const {
+  namespace Names = ScreeningPipelineSettingsNames;
+  const auto keepFractions = _settings.getDoubleList(Names::keepFractions);
+  const auto energyWindows = _settings.getDoubleList(Names::energyWindows);
+  const double keepFraction = keepFractions.empty() ? 1.0 : keepFractions[stage];
+  const double energyWindow = energyWindows.empty() ? 0.0 : energyWindows[stage];
+  const unsigned minimumKept = _settings.getInt(Names::minimumKept);
+
+  std::vector<int> valid;
+  for (unsigned n = 0; n < candidates.size(); ++n) {
+    if (std::isfinite(energies[n])) {
+      valid.push_back(n);
+    }
+  }
+  std::sort(valid.begin(), valid.end(), [&](int a, int b) { return energies[a] < energies[b]; });
+  if (valid.empty()) {
+    return valid;
+  }
+  const std::size_t nFraction = std::ceil(keepFraction * valid.size());
+  const std::size_t nKeep = std::min<std::size_t>(valid.size(), std::max<std::size_t>(minimumKept, nFraction));
+  if (energyWindow > 0.0) {
+    // Structures within the minimum count are kept even if they are outside the window
+    const double cutoff = energies[valid.front()] + energyWindow;
+    const std::size_t nInWindow =
+        std::count_if(valid.begin(), valid.end(), [&](int n) { return energies[n] <= cutoff; });
+    valid.resize(std::max<std::size_t>(nInWindow, std::min<std::size_t>(minimumKept, valid.size())));
+  }
+  if (valid.size() <= nKeep) {
+    return valid;
+  }
+  if (_settings.getString(Names::selection) == "energy") {
+    valid.resize(nKeep);
+    return valid;
+  }
+
+  // Greedy max-min diversity selection on the RMSD of the interatomic distances
+  std::vector<Eigen::VectorXd> distances;
+  for (const int n : valid) {
+    const auto& positions = ensemble[candidates[n]].getPositions();
+    const int nAtoms = positions.rows();
+    Eigen::VectorXd d(nAtoms * (nAtoms - 1) / 2);
+    int k = 0;
+    for (int i = 0; i < nAtoms; ++i) {
+      for (int j = i + 1; j < nAtoms; ++j) {
+        d(k++) = (positions.row(i) - positions.row(j)).norm();
+      }
+    }
+    distances.push_back(std::move(d));
+  }
+  auto rmsd = [&](int a, int b) {
+    if (distances[a].size() != distances[b].size() || distances[a].size() == 0) {
+      return std::numeric_limits<double>::infinity();
+    }
+    return std::sqrt((distances[a] - distances[b]).squaredNorm() / distances[a].size());
+  };
+  std::vector<int> selected = {0};
+  std::vector<double> minimumDistance(valid.size(), std::numeric_limits<double>::infinity());
+  minimumDistance[0] = 0.0;
+  while (selected.size() < nKeep) {
+    int best = -1;
+    for (unsigned n = 0; n < valid.size(); ++n) {
+      minimumDistance[n] = std::min(minimumDistance[n], rmsd(n, selected.back()));
+      if (minimumDistance[n] > 0.0 && (best < 0 || minimumDistance[n] > minimumDistance[best])) {
+        best = n;
+      }
+    }
+    if (best < 0) {
+      break;
+    }
+    selected.push_back(best);
+    minimumDistance[best] = 0.0;
+  }
+  std::vector<int> result;
+  for (const int n : selected) {
+    result.push_back(valid[n]);
+  }
+  return result;
+}
+
+} /* namespace Xtb */
+} /* namespace Scine */
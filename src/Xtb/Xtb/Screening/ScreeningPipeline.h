@@ -0,0 +1,83 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_SCREENINGPIPELINE_H_
+#define XTB_SCREENINGPIPELINE_H_
+
+/* Internal Includes */
+#include "Xtb/Screening/ScreeningPipelineSettings.h"
+/* External Includes */
+#include <Utils/Geometry/AtomCollection.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Scine {
+namespace Xtb {
+
+class XtbCalculatorBase;
+
+/**
+ * @class ScreeningPipeline
+ * @brief Multi-level screening of an ensemble of structures.
+ *
+ * The ensemble is evaluated with the calculator of the first stage, e.g.
+ * GFN-FF, and only the lowest-energy (or a maximally diverse) fraction is
+ * passed on to the next, more expensive stage, e.g. GFN0 and then GFN2. The
+ * calculations of each stage run in parallel, each thread with a clone of the
+ * stage calculator.
+ */
+class ScreeningPipeline {
+ public:
+  /// @brief The summary of one stage of the screening.
+  struct StageReport {
+    std::string method;
+    int nEvaluated = 0;
+    int nFailed = 0;
+    int nKept = 0;
+    /// @brief The wall-clock time of the stage in seconds.
+    double wallTime = 0.0;
+  };
+  /// @brief The outcome of the screening.
+  struct Result {
+    /// @brief The indices of the structures passing all stages, sorted by their final energy.
+    std::vector<int> indices;
+    /// @brief The energies of the last stage, in the order of the indices.
+    std::vector<double> energies;
+    std::vector<StageReport> stages;
+  };
+  /**
+   * @brief Constructor.
+   * @param stages The calculators of the stages, from the cheapest to the most
+   *               accurate one. Their settings (charge, multiplicity, solvation,
+   *               ...) are used for all structures.
+   */
+  explicit ScreeningPipeline(std::vector<std::shared_ptr<XtbCalculatorBase>> stages);
+  /// @brief Accessor for the settings of the screening.
+  Utils::Settings& settings();
+  /// @brief Const accessor for the settings of the screening.
+  const Utils::Settings& settings() const;
+  /**
+   * @brief Screens the given ensemble.
+   * @param ensemble The structures.
+   * @return Result The surviving structures and the report of each stage.
+   */
+  Result screen(const std::vector<Utils::AtomCollection>& ensemble);
+
+ private:
+  std::vector<double> _evaluate(const XtbCalculatorBase& calculator, const std::vector<Utils::AtomCollection>& ensemble,
+                                const std::vector<int>& candidates) const;
+  std::vector<int> _select(const std::vector<Utils::AtomCollection>& ensemble, const std::vector<int>& candidates,
+                           const std::vector<double>& energies, int stage) const;
+
+  std::vector<std::shared_ptr<XtbCalculatorBase>> _stages;
+  ScreeningPipelineSettings _settings;
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_SCREENINGPIPELINE_H_ */
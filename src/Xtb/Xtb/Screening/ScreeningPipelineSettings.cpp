@@ -0,0 +1,53 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Screening/ScreeningPipelineSettings.h"
+
+namespace Scine {
+namespace Xtb {
+
+ScreeningPipelineSettings::ScreeningPipelineSettings() : Scine::Utils::Settings("ScreeningPipelineSettings") {
+  using namespace Scine::Utils::UniversalSettings;
+  namespace Names = ScreeningPipelineSettingsNames;
+
+  // Selection
+  OptionListDescriptor selection("How the structures passed on to the next stage are chosen, 'energy' for the "
+                                 "lowest energies or 'diversity' for a maximally diverse subset (by the RMSD of the "
+                                 "interatomic distances), starting from the lowest energy.");
+  selection.addOption("energy");
+  selection.addOption("diversity");
+  selection.setDefaultOption("energy");
+  this->_fields.push_back(Names::selection, selection);
+
+  DoubleListDescriptor keepFractions("The fraction of the structures kept after each stage. If empty, all structures "
+                                     "are kept; otherwise one value per stage is required.");
+  this->_fields.push_back(Names::keepFractions, keepFractions);
+
+  DoubleListDescriptor energyWindows("The energy window above the lowest energy in hartree within which structures "
+                                     "are kept after each stage, 0 for no window. If empty, no windows are applied; "
+                                     "otherwise one value per stage is required.");
+  this->_fields.push_back(Names::energyWindows, energyWindows);
+
+  IntDescriptor minimumKept("The minimum number of structures kept after each stage, regardless of the fractions "
+                            "and windows.");
+  minimumKept.setMinimum(1);
+  minimumKept.setDefaultValue(1);
+  this->_fields.push_back(Names::minimumKept, minimumKept);
+
+  // Reuse
+  BoolDescriptor reuseSessions("Whether each thread reuses its xtb session for consecutive structures with the same "
+                               "elements. This keeps the topology (GFN-FF) and restarts the SCF from the previous "
+                               "wavefunction, and requires all structures to be conformers of the same molecule.");
+  reuseSessions.setDefaultValue(true);
+  this->_fields.push_back(Names::reuseSessions, reuseSessions);
+
+  this->resetToDefaults();
+}
+
+} /* namespace Xtb */
+} /* namespace Scine */
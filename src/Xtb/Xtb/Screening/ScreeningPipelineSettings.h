@@ -0,0 +1,39 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_SCREENINGPIPELINESETTINGS_H_
+#define XTB_SCREENINGPIPELINESETTINGS_H_
+
+/* External Includes */
+#include <Utils/Settings.h>
+
+namespace Scine {
+namespace Xtb {
+
+namespace ScreeningPipelineSettingsNames {
+static constexpr const char* selection = "selection";
+static constexpr const char* keepFractions = "keep_fractions";
+static constexpr const char* energyWindows = "energy_windows";
+static constexpr const char* minimumKept = "minimum_kept";
+static constexpr const char* reuseSessions = "reuse_sessions";
+} // namespace ScreeningPipelineSettingsNames
+
+/**
+ * @class ScreeningPipelineSettings
+ * @brief The settings of the multi-level screening pipeline.
+ */
+class ScreeningPipelineSettings : public Scine::Utils::Settings {
+ public:
+  /**
+   * @brief Construct a new ScreeningPipelineSettings object.
+   */
+  ScreeningPipelineSettings();
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_SCREENINGPIPELINESETTINGS_H_ */
@@ -0,0 +1,53 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Server/CalculationClient.h"
+/* External Includes */
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace Scine {
+namespace Xtb {
+
+CalculationClient::CalculationClient(const std::string& socketPath) {
+  sockaddr_un address{};
+  if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+    throw std::runtime_error("The socket path '" + socketPath + "' is empty or too long.");
+  }
+  address.sun_family = AF_UNIX;
+  std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+  _socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (_socket < 0) {
+    throw std::runtime_error(std::string("Could not create a socket: ") + std::strerror(errno));
+  }
+  if (::connect(_socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+    const std::string reason = std::strerror(errno);
+    ::close(_socket);
+    throw std::runtime_error("Could not connect to the calculation server at '" + socketPath + "': " + reason);
+  }
+}
+
+CalculationClient::~CalculationClient() {
+  ::close(_socket);
+}
+
+CalculationResponse CalculationClient::calculate(const CalculationRequest& request) {
+  ServerProtocol::writeFrame(_socket, ServerProtocol::encodeRequest(request));
+  std::string payload;
+  if (!ServerProtocol::readFrame(_socket, payload)) {
+    throw std::runtime_error("The calculation server closed the connection.");
+  }
+  return ServerProtocol::decodeResponse(payload);
+}
+
+} /* namespace Xtb */
+} /* namespace Scine */
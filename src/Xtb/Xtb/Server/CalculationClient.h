@@ -0,0 +1,50 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_CALCULATIONCLIENT_H_
+#define XTB_CALCULATIONCLIENT_H_
+
+/* Internal Includes */
+#include "Xtb/Server/ServerProtocol.h"
+/* External Includes */
+#include <string>
+
+namespace Scine {
+namespace Xtb {
+
+/**
+ * @class CalculationClient
+ * @brief A connection to a CalculationServer.
+ *
+ * The connection stays open for the lifetime of the client, requests are
+ * answered in order.
+ */
+class CalculationClient {
+ public:
+  /**
+   * @brief Connects to a server.
+   * @param socketPath The socket_path of the server.
+   */
+  explicit CalculationClient(const std::string& socketPath);
+  ~CalculationClient();
+  CalculationClient(const CalculationClient&) = delete;
+  CalculationClient& operator=(const CalculationClient&) = delete;
+  /**
+   * @brief Sends a request and waits for its response.
+   *
+   * A failed calculation is reported within the response, only failures of
+   * the connection throw.
+   */
+  CalculationResponse calculate(const CalculationRequest& request);
+
+ private:
+  int _socket = -1;
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_CALCULATIONCLIENT_H_ */
@@ -0,0 +1,377 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Server/CalculationServer.h"
+#include "Xtb/Wrapper/XtbCalculatorBase.h"
+#include "Xtb/Wrapper/XtbSession.h"
+/* External Includes */
+#include <Utils/Bonds/BondOrderCollection.h>
+#include <Utils/UniversalSettings/SettingsNames.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace Scine {
+namespace Xtb {
+
+namespace {
+// How often blocked threads check whether the server was stopped
+constexpr int pollInterval = 100;
+
+void modify(Utils::Settings& settings, const std::string& key, int value) {
+  settings.modifyInt(key, value);
+}
+void modify(Utils::Settings& settings, const std::string& key, double value) {
+  settings.modifyDouble(key, value);
+}
+void modify(Utils::Settings& settings, const std::string& key, bool value) {
+  settings.modifyBool(key, value);
+}
+void modify(Utils::Settings& settings, const std::string& key, const std::string& value) {
+  settings.modifyString(key, value);
+}
+void modify(Utils::Settings& settings, const std::string& key, const std::vector<double>& value) {
+  settings.modifyDoubleList(key, value);
+}
+} // namespace
+
+CalculationServer::CalculationServer() = default;
+
+CalculationServer::~CalculationServer() = default;
+
+Utils::Settings& CalculationServer::settings() {
+  return _settings;
+}
+
+const Utils::Settings& CalculationServer::settings() const {
+  return _settings;
+}
+
+void CalculationServer::stop() noexcept {
+  _stop.store(true);
+}
+
+CalculationServer::Statistics CalculationServer::statistics() const {
+  Statistics statistics;
+  statistics.connections = _connections.load();
+  statistics.requests = _requests.load();
+  statistics.cacheHits = _cacheHits.load();
+  statistics.sessionHits = _sessionHits.load();
+  statistics.failures = _failures.load();
+  return statistics;
+}
+
+void CalculationServer::run() {
+  if (!_settings.valid()) {
+    _settings.throwIncorrectSettings();
+  }
+  _warmup();
+  const int listener = _listen();
+  std::vector<Worker> workers(_settings.getInt(CalculationServerSettingsNames::workers));
+  std::vector<std::thread> threads;
+  for (auto& worker : workers) {
+    threads.emplace_back([&]() { _work(worker); });
+  }
+  std::exception_ptr error;
+  try {
+    while (!_stop.load()) {
+      pollfd request{listener, POLLIN, 0};
+      const int ready = ::poll(&request, 1, pollInterval);
+      if (ready < 0 && errno != EINTR) {
+        throw std::runtime_error(std::string("Could not wait for connections: ") + std::strerror(errno));
+      }
+      if (ready <= 0) {
+        continue;
+      }
+      const int connection = ::accept(listener, nullptr, nullptr);
+      if (connection < 0) {
+        continue;
+      }
+      // A client stalling within a message must not block its worker, and with it stop()
+      const double timeout = _settings.getDouble(CalculationServerSettingsNames::connectionTimeout);
+      timeval interval{};
+      interval.tv_sec = static_cast<time_t>(timeout);
+      interval.tv_usec = static_cast<suseconds_t>(1e6 * (timeout - interval.tv_sec));
+      if (::setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &interval, sizeof(interval)) != 0 ||
+          ::setsockopt(connection, SOL_SOCKET, SO_SNDTIMEO, &interval, sizeof(interval)) != 0) {
+        ::close(connection);
+        continue;
+      }
+      ++_connections;
+      {
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        _queue.push_back(connection);
+      }
+      _queueCondition.notify_one();
+    }
+  }
+  catch (...) {
+    error = std::current_exception();
+    stop();
+  }
+  ::close(listener);
+  ::unlink(_settings.getString(CalculationServerSettingsNames::socketPath).c_str());
+  _queueCondition.notify_all();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const int connection : _queue) {
+    ::close(connection);
+  }
+  _queue.clear();
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+int CalculationServer::_listen() {
+  const std::string path = _settings.getString(CalculationServerSettingsNames::socketPath);
+  sockaddr_un address{};
+  if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+    throw std::runtime_error("The socket path '" + path + "' is empty or too long.");
+  }
+  address.sun_family = AF_UNIX;
+  std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+  const int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listener < 0) {
+    throw std::runtime_error(std::string("Could not create the server socket: ") + std::strerror(errno));
+  }
+  // Replace a socket left behind by a server that did not shut down, but never a running one or another file
+  struct stat status {};
+  if (::lstat(path.c_str(), &status) == 0) {
+    if (!S_ISSOCK(status.st_mode)) {
+      ::close(listener);
+      throw std::runtime_error("The socket path '" + path + "' exists and is not a socket.");
+    }
+    if (::connect(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0) {
+      ::close(listener);
+      throw std::runtime_error("Another server is listening on '" + path + "'.");
+    }
+    ::unlink(path.c_str());
+  }
+  const mode_t mask = ::umask(0077);
+  const int bound = ::bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+  ::umask(mask);
+  if (bound != 0 || ::listen(listener, SOMAXCONN) != 0) {
+    const std::string reason = std::strerror(errno);
+    ::close(listener);
+    throw std::runtime_error("Could not listen on '" + path + "': " + reason);
+  }
+  return listener;
+}
+
+void CalculationServer::_warmup() {
+  Utils::PositionCollection positions = Utils::PositionCollection::Zero(2, 3);
+  positions(1, 0) = 1.4;
+  const Utils::AtomCollection hydrogen({Utils::ElementType::H, Utils::ElementType::H}, positions);
+  for (const auto& method : _settings.getStringList(CalculationServerSettingsNames::warmMethods)) {
+    auto calculator = XtbCalculatorBase::create(method);
+    calculator->settings().modifyInt(Utils::SettingsNames::externalProgramNProcs,
+                                     _settings.getInt(CalculationServerSettingsNames::threadsPerWorker));
+    calculator->setStructure(hydrogen);
+    calculator->calculate("");
+  }
+}
+
+void CalculationServer::_work(Worker& worker) {
+  while (true) {
+    int connection = -1;
+    {
+      std::unique_lock<std::mutex> lock(_queueMutex);
+      _queueCondition.wait_for(lock, std::chrono::milliseconds(pollInterval),
+                               [&]() { return _stop.load() || !_queue.empty(); });
+      if (_stop.load()) {
+        return;
+      }
+      if (_queue.empty()) {
+        continue;
+      }
+      connection = _queue.front();
+      _queue.pop_front();
+    }
+    _serve(worker, connection);
+    ::close(connection);
+  }
+}
+
+void CalculationServer::_serve(Worker& worker, int connection) {
+  std::string payload;
+  while (!_stop.load()) {
+    pollfd request{connection, POLLIN, 0};
+    const int ready = ::poll(&request, 1, pollInterval);
+    if (ready < 0 && errno != EINTR) {
+      return;
+    }
+    if (ready <= 0) {
+      continue;
+    }
+    // Broken frames and closed connections end the connection, failed calculations are answered
+    try {
+      if (!ServerProtocol::readFrame(connection, payload)) {
+        return;
+      }
+      ServerProtocol::writeFrame(connection, _handle(worker, payload));
+    }
+    catch (const std::exception& /* e */) {
+      return;
+    }
+  }
+}
+
+std::string CalculationServer::_handle(Worker& worker, const std::string& payload) {
+  ++_requests;
+  std::string response;
+  if (_lookup(payload, response)) {
+    ++_cacheHits;
+    ServerProtocol::markCached(response);
+    return response;
+  }
+  CalculationResponse result;
+  try {
+    result = _calculate(worker, ServerProtocol::decodeRequest(payload));
+  }
+  catch (const std::exception& e) {
+    ++_failures;
+    CalculationResponse failure;
+    failure.error = e.what();
+    return ServerProtocol::encodeResponse(failure);
+  }
+  response = ServerProtocol::encodeResponse(result);
+  _store(payload, response);
+  return response;
+}
+
+CalculationResponse CalculationServer::_calculate(Worker& worker, const CalculationRequest& request) {
+  Session& entry = _session(worker, request);
+  auto& calculator = *entry.calculator;
+  Utils::PropertyList properties(Utils::Property::Energy);
+  if (request.properties & ServerProperties::gradients) {
+    properties.addProperty(Utils::Property::Gradients);
+  }
+  if (request.properties & ServerProperties::atomicCharges) {
+    properties.addProperty(Utils::Property::AtomicCharges);
+  }
+  if (request.properties & ServerProperties::dipole) {
+    properties.addProperty(Utils::Property::Dipole);
+  }
+  if (request.properties & ServerProperties::hessian) {
+    properties.addProperty(Utils::Property::Hessian);
+  }
+  if (request.properties & ServerProperties::bondOrders) {
+    properties.addProperty(Utils::Property::BondOrderMatrix);
+  }
+  calculator.setRequiredProperties(properties);
+  Utils::Results results;
+  try {
+    if (request.properties & ServerProperties::hessian) {
+      calculator.calculate("");
+    }
+    else {
+      if (!entry.session) {
+        entry.session = calculator.createSession();
+      }
+      calculator.calculate(*entry.session);
+    }
+    results = calculator.takeResults();
+  }
+  catch (...) {
+    // The session may be left in any state
+    worker.sessions.pop_front();
+    throw;
+  }
+  const auto maxSessions =
+      static_cast<std::size_t>(_settings.getInt(CalculationServerSettingsNames::sessionsPerWorker));
+  while (worker.sessions.size() > maxSessions) {
+    worker.sessions.pop_back();
+  }
+
+  CalculationResponse response;
+  response.success = true;
+  response.properties = request.properties;
+  response.energy = results.get<Utils::Property::Energy>();
+  if (request.properties & ServerProperties::gradients) {
+    response.gradients = results.get<Utils::Property::Gradients>();
+  }
+  if (request.properties & ServerProperties::atomicCharges) {
+    response.atomicCharges = results.get<Utils::Property::AtomicCharges>();
+  }
+  if (request.properties & ServerProperties::dipole) {
+    response.dipole = results.get<Utils::Property::Dipole>();
+  }
+  if (request.properties & ServerProperties::hessian) {
+    response.hessian = results.get<Utils::Property::Hessian>();
+  }
+  if (request.properties & ServerProperties::bondOrders) {
+    response.bondOrders = Eigen::MatrixXd(results.get<Utils::Property::BondOrderMatrix>().getMatrix());
+  }
+  return response;
+}
+
+CalculationServer::Session& CalculationServer::_session(Worker& worker, const CalculationRequest& request) {
+  const std::string key = ServerProtocol::sessionKey(request);
+  for (auto it = worker.sessions.begin(); it != worker.sessions.end(); ++it) {
+    if (it->key == key) {
+      ++_sessionHits;
+      worker.sessions.splice(worker.sessions.begin(), worker.sessions, it);
+      worker.sessions.front().calculator->modifyPositions(request.structure.getPositions());
+      return worker.sessions.front();
+    }
+  }
+  Session entry;
+  entry.key = key;
+  entry.calculator = XtbCalculatorBase::create(request.method);
+  auto& settings = entry.calculator->settings();
+  for (const auto& setting : request.settings) {
+    std::visit([&](const auto& value) { modify(settings, setting.first, value); }, setting.second);
+  }
+  settings.modifyInt(Utils::SettingsNames::externalProgramNProcs,
+                     _settings.getInt(CalculationServerSettingsNames::threadsPerWorker));
+  entry.calculator->setStructure(request.structure);
+  worker.sessions.push_front(std::move(entry));
+  return worker.sessions.front();
+}
+
+bool CalculationServer::_lookup(const std::string& request, std::string& response) {
+  std::lock_guard<std::mutex> lock(_cacheMutex);
+  const auto it = _cacheIndex.find(request);
+  if (it == _cacheIndex.end()) {
+    return false;
+  }
+  _cache.splice(_cache.begin(), _cache, it->second);
+  response = it->second->second;
+  return true;
+}
+
+void CalculationServer::_store(const std::string& request, const std::string& response) {
+  const auto cacheSize = static_cast<std::size_t>(_settings.getInt(CalculationServerSettingsNames::cacheSize));
+  if (cacheSize == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(_cacheMutex);
+  if (_cacheIndex.count(request) > 0) {
+    return;
+  }
+  _cache.emplace_front(request, response);
+  _cacheIndex[request] = _cache.begin();
+  while (_cache.size() > cacheSize) {
+    _cacheIndex.erase(_cache.back().first);
+    _cache.pop_back();
+  }
+}
+
+} /* namespace Xtb */
+} /* namespace Scine */
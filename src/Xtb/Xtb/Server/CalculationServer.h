@@ -0,0 +1,117 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_CALCULATIONSERVER_H_
+#define XTB_CALCULATIONSERVER_H_
+
+/* Internal Includes */
+#include "Xtb/Server/CalculationServerSettings.h"
+#include "Xtb/Server/ServerProtocol.h"
+/* External Includes */
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace Scine {
+namespace Xtb {
+
+class XtbCalculatorBase;
+class XtbSession;
+
+/**
+ * @class CalculationServer
+ * @brief Serves calculation requests of local clients over a Unix domain
+ *        socket from a pool of warm calculators.
+ *
+ * Accepted connections are handed to a fixed number of worker threads, each
+ * connection sends any number of requests and receives one response per
+ * request, see ServerProtocol for the wire format. Each worker keeps the most
+ * recently used sessions, so a request with the method, elements and
+ * settings of an earlier one only updates the positions and restarts the SCF
+ * from the last wavefunction. Identical requests are answered from a result
+ * cache shared by all workers. Hessians are calculated without a session.
+ * A connection stalling within a message for longer than the
+ * connection_timeout is closed.
+ */
+class CalculationServer {
+ public:
+  /// @brief Counters of the served requests.
+  struct Statistics {
+    std::uint64_t connections = 0;
+    std::uint64_t requests = 0;
+    std::uint64_t cacheHits = 0;
+    std::uint64_t sessionHits = 0;
+    std::uint64_t failures = 0;
+  };
+  CalculationServer();
+  ~CalculationServer();
+  CalculationServer(const CalculationServer&) = delete;
+  CalculationServer& operator=(const CalculationServer&) = delete;
+  /// @brief Accessor for the settings of the server, to be modified before run().
+  Utils::Settings& settings();
+  /// @brief Const accessor for the settings of the server.
+  const Utils::Settings& settings() const;
+  /**
+   * @brief Warms up the workers, listens on the socket and serves requests
+   *        until stop() is called.
+   */
+  void run();
+  /**
+   * @brief Makes run() return after the running calculations finished.
+   *
+   * Only sets a flag, so it may be called from a signal handler.
+   */
+  void stop() noexcept;
+  /// @brief The counters since the construction.
+  Statistics statistics() const;
+
+ private:
+  struct Session {
+    std::string key;
+    std::shared_ptr<XtbCalculatorBase> calculator;
+    std::unique_ptr<XtbSession> session;
+  };
+  struct Worker {
+    // Most recently used first
+    std::list<Session> sessions;
+  };
+  int _listen();
+  void _work(Worker& worker);
+  void _serve(Worker& worker, int connection);
+  std::string _handle(Worker& worker, const std::string& payload);
+  CalculationResponse _calculate(Worker& worker, const CalculationRequest& request);
+  Session& _session(Worker& worker, const CalculationRequest& request);
+  void _warmup();
+  bool _lookup(const std::string& request, std::string& response);
+  void _store(const std::string& request, const std::string& response);
+
+  CalculationServerSettings _settings;
+  std::atomic<bool> _stop{false};
+  // Accepted connections waiting for a worker
+  std::mutex _queueMutex;
+  std::condition_variable _queueCondition;
+  std::deque<int> _queue;
+  // Encoded requests and their encoded responses, most recently used first
+  std::mutex _cacheMutex;
+  std::list<std::pair<std::string, std::string>> _cache;
+  std::unordered_map<std::string, std::list<std::pair<std::string, std::string>>::iterator> _cacheIndex;
+  std::atomic<std::uint64_t> _connections{0};
+  std::atomic<std::uint64_t> _requests{0};
+  std::atomic<std::uint64_t> _cacheHits{0};
+  std::atomic<std::uint64_t> _sessionHits{0};
+  std::atomic<std::uint64_t> _failures{0};
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_CALCULATIONSERVER_H_ */
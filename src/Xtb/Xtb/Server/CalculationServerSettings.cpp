@@ -0,0 +1,61 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Server/CalculationServerSettings.h"
+
+namespace Scine {
+namespace Xtb {
+
+CalculationServerSettings::CalculationServerSettings() : Scine::Utils::Settings("CalculationServerSettings") {
+  using namespace Scine::Utils::UniversalSettings;
+  namespace Names = CalculationServerSettingsNames;
+
+  StringDescriptor socketPath("The path of the Unix domain socket the server listens on. The socket is only "
+                              "accessible to the user running the server.");
+  socketPath.setDefaultValue("/tmp/scine_xtb.socket");
+  this->_fields.push_back(Names::socketPath, socketPath);
+
+  // Pool
+  IntDescriptor workers("The number of worker threads, i.e. of calculations running at the same time.");
+  workers.setMinimum(1);
+  workers.setDefaultValue(1);
+  this->_fields.push_back(Names::workers, workers);
+
+  IntDescriptor threadsPerWorker("The number of OpenMP threads of each calculation (externalProgramNProcs), "
+                                 "overriding the value of the requests.");
+  threadsPerWorker.setMinimum(1);
+  threadsPerWorker.setDefaultValue(1);
+  this->_fields.push_back(Names::threadsPerWorker, threadsPerWorker);
+
+  IntDescriptor sessionsPerWorker("The number of sessions each worker keeps open. Requests with the same method, "
+                                  "elements and settings continue a session from its last wavefunction.");
+  sessionsPerWorker.setMinimum(0);
+  sessionsPerWorker.setDefaultValue(8);
+  this->_fields.push_back(Names::sessionsPerWorker, sessionsPerWorker);
+
+  IntDescriptor cacheSize("The number of responses kept for identical requests. Zero disables the cache.");
+  cacheSize.setMinimum(0);
+  cacheSize.setDefaultValue(1024);
+  this->_fields.push_back(Names::cacheSize, cacheSize);
+
+  StringListDescriptor warmMethods("The methods a calculation of H2 is run with before the server accepts "
+                                   "connections, which initializes xtb and its Fortran runtime.");
+  warmMethods.setDefaultValue({"GFN2"});
+  this->_fields.push_back(Names::warmMethods, warmMethods);
+
+  DoubleDescriptor connectionTimeout("The time in seconds a client may stall within a message before its connection "
+                                     "is closed. Waiting between messages is not limited.");
+  connectionTimeout.setMinimum(0.001);
+  connectionTimeout.setDefaultValue(10.0);
+  this->_fields.push_back(Names::connectionTimeout, connectionTimeout);
+
+  this->resetToDefaults();
+}
+
+} /* namespace Xtb */
+} /* namespace Scine */
@@ -0,0 +1,41 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_CALCULATIONSERVERSETTINGS_H_
+#define XTB_CALCULATIONSERVERSETTINGS_H_
+
+/* External Includes */
+#include <Utils/Settings.h>
+
+namespace Scine {
+namespace Xtb {
+
+namespace CalculationServerSettingsNames {
+static constexpr const char* socketPath = "socket_path";
+static constexpr const char* workers = "workers";
+static constexpr const char* threadsPerWorker = "threads_per_worker";
+static constexpr const char* sessionsPerWorker = "sessions_per_worker";
+static constexpr const char* cacheSize = "cache_size";
+static constexpr const char* warmMethods = "warm_methods";
+static constexpr const char* connectionTimeout = "connection_timeout";
+} // namespace CalculationServerSettingsNames
+
+/**
+ * @class CalculationServerSettings
+ * @brief The settings of the calculation server.
+ */
+class CalculationServerSettings : public Scine::Utils::Settings {
+ public:
+  /**
+   * @brief Construct a new CalculationServerSettings object.
+   */
+  CalculationServerSettings();
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_CALCULATIONSERVERSETTINGS_H_ */
@@ -0,0 +1,347 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Server/ServerProtocol.h"
+/* External Includes */
+#include <Utils/Geometry/ElementInfo.h>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <type_traits>
+
+namespace Scine {
+namespace Xtb {
+
+namespace {
+
+enum class SettingType : std::uint8_t { Int = 0, Double = 1, Bool = 2, String = 3, DoubleList = 4 };
+
+class Writer {
+ public:
+  template<class T>
+  void put(const T& value) {
+    static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be written.");
+    _data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+  void putDoubles(const double* values, std::size_t n) {
+    put(static_cast<std::uint32_t>(n));
+    _data.append(reinterpret_cast<const char*>(values), n * sizeof(double));
+  }
+  void putString(const std::string& value) {
+    put(static_cast<std::uint32_t>(value.size()));
+    _data.append(value);
+  }
+  std::string& data() {
+    return _data;
+  }
+
+ private:
+  std::string _data;
+};
+
+class Reader {
+ public:
+  explicit Reader(const std::string& data) : _data(data) {
+  }
+  template<class T>
+  T get() {
+    T value;
+    std::memcpy(&value, _take(sizeof(T)), sizeof(T));
+    return value;
+  }
+  std::vector<double> getDoubles() {
+    const auto n = get<std::uint32_t>();
+    std::vector<double> values(n);
+    if (n > 0) {
+      std::memcpy(values.data(), _take(n * sizeof(double)), n * sizeof(double));
+    }
+    return values;
+  }
+  // Reads exactly n doubles, e.g. into the storage of an Eigen matrix
+  void getDoubles(double* values, std::size_t n) {
+    if (get<std::uint32_t>() != n) {
+      throw std::runtime_error("Malformed message of the calculation server: unexpected array size.");
+    }
+    if (n > 0) {
+      std::memcpy(values, _take(n * sizeof(double)), n * sizeof(double));
+    }
+  }
+  std::string getString() {
+    const auto n = get<std::uint32_t>();
+    return std::string(_take(n), n);
+  }
+  void finish() const {
+    if (_offset != _data.size()) {
+      throw std::runtime_error("Malformed message of the calculation server: trailing bytes.");
+    }
+  }
+
+ private:
+  const char* _take(std::size_t n) {
+    if (n > _data.size() - _offset) {
+      throw std::runtime_error("Malformed message of the calculation server: message too short.");
+    }
+    const char* start = _data.data() + _offset;
+    _offset += n;
+    return start;
+  }
+  const std::string& _data;
+  std::size_t _offset = 0;
+};
+
+void putElements(Writer& writer, const Utils::ElementTypeCollection& elements) {
+  writer.put(static_cast<std::uint32_t>(elements.size()));
+  for (const auto element : elements) {
+    writer.put(static_cast<std::uint16_t>(Utils::ElementInfo::Z(element)));
+  }
+}
+
+void putSettings(Writer& writer, const std::vector<std::pair<std::string, ServerSettingValue>>& settings) {
+  writer.put(static_cast<std::uint32_t>(settings.size()));
+  for (const auto& setting : settings) {
+    writer.putString(setting.first);
+    writer.put(static_cast<std::uint8_t>(setting.second.index()));
+    std::visit(
+        [&](const auto& value) {
+          using T = std::decay_t<decltype(value)>;
+          if constexpr (std::is_same<T, std::string>::value) {
+            writer.putString(value);
+          }
+          else if constexpr (std::is_same<T, std::vector<double>>::value) {
+            writer.putDoubles(value.data(), value.size());
+          }
+          else if constexpr (std::is_same<T, bool>::value) {
+            writer.put(static_cast<std::uint8_t>(value));
+          }
+          else {
+            writer.put(value);
+          }
+        },
+        setting.second);
+  }
+}
+
+void fullySend(int socket, const char* data, std::size_t n) {
+#if defined(MSG_NOSIGNAL)
+  const int flags = MSG_NOSIGNAL;
+#else
+  const int flags = 0;
+#endif
+  while (n > 0) {
+    const ssize_t sent = ::send(socket, data, n, flags);
+    if (sent < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        throw std::runtime_error("Timed out sending to the calculation server socket.");
+      }
+      throw std::runtime_error(std::string("Could not send to the calculation server socket: ") + std::strerror(errno));
+    }
+    data += sent;
+    n -= sent;
+  }
+}
+
+// Returns the number of bytes read, less than n only at the end of the stream
+std::size_t fullyReceive(int socket, char* data, std::size_t n) {
+  std::size_t received = 0;
+  while (received < n) {
+    const ssize_t r = ::recv(socket, data + received, n - received, 0);
+    if (r < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        throw std::runtime_error("Timed out reading from the calculation server socket.");
+      }
+      throw std::runtime_error(std::string("Could not read from the calculation server socket: ") +
+                               std::strerror(errno));
+    }
+    if (r == 0) {
+      break;
+    }
+    received += r;
+  }
+  return received;
+}
+
+} // namespace
+
+std::string ServerProtocol::encodeRequest(const CalculationRequest& request) {
+  Writer writer;
+  writer.put(version);
+  writer.putString(request.method);
+  putElements(writer, request.structure.getElements());
+  const auto& positions = request.structure.getPositions();
+  writer.putDoubles(positions.data(), positions.size());
+  putSettings(writer, request.settings);
+  writer.put(request.properties);
+  return std::move(writer.data());
+}
+
+CalculationRequest ServerProtocol::decodeRequest(const std::string& payload) {
+  Reader reader(payload);
+  if (reader.get<std::uint8_t>() != version) {
+    throw std::runtime_error("The request was encoded with another version of the server protocol.");
+  }
+  CalculationRequest request;
+  request.method = reader.getString();
+  const auto nAtoms = reader.get<std::uint32_t>();
+  Utils::ElementTypeCollection elements(nAtoms);
+  for (auto& element : elements) {
+    element = Utils::ElementInfo::element(reader.get<std::uint16_t>());
+  }
+  Utils::PositionCollection positions(nAtoms, 3);
+  reader.getDoubles(positions.data(), positions.size());
+  request.structure = Utils::AtomCollection(elements, positions);
+  const auto nSettings = reader.get<std::uint32_t>();
+  for (std::uint32_t i = 0; i < nSettings; ++i) {
+    std::string key = reader.getString();
+    ServerSettingValue value;
+    switch (static_cast<SettingType>(reader.get<std::uint8_t>())) {
+      case SettingType::Int:
+        value = reader.get<int>();
+        break;
+      case SettingType::Double:
+        value = reader.get<double>();
+        break;
+      case SettingType::Bool:
+        value = reader.get<std::uint8_t>() != 0;
+        break;
+      case SettingType::String:
+        value = reader.getString();
+        break;
+      case SettingType::DoubleList:
+        value = reader.getDoubles();
+        break;
+      default:
+        throw std::runtime_error("Malformed message of the calculation server: unknown type of setting '" + key +
+                                 "'.");
+    }
+    request.settings.emplace_back(std::move(key), std::move(value));
+  }
+  request.properties = reader.get<std::uint32_t>();
+  reader.finish();
+  return request;
+}
+
+std::string ServerProtocol::encodeResponse(const CalculationResponse& response) {
+  Writer writer;
+  writer.put(static_cast<std::uint8_t>(response.success));
+  writer.put(static_cast<std::uint8_t>(response.cached));
+  if (!response.success) {
+    writer.putString(response.error);
+    return std::move(writer.data());
+  }
+  writer.put(response.properties);
+  writer.put(response.energy);
+  if (response.properties & ServerProperties::gradients) {
+    writer.put(static_cast<std::uint32_t>(response.gradients.rows()));
+    writer.putDoubles(response.gradients.data(), response.gradients.size());
+  }
+  if (response.properties & ServerProperties::atomicCharges) {
+    writer.putDoubles(response.atomicCharges.data(), response.atomicCharges.size());
+  }
+  if (response.properties & ServerProperties::dipole) {
+    writer.putDoubles(response.dipole.data(), 3);
+  }
+  if (response.properties & ServerProperties::hessian) {
+    writer.put(static_cast<std::uint32_t>(response.hessian.rows()));
+    writer.putDoubles(response.hessian.data(), response.hessian.size());
+  }
+  if (response.properties & ServerProperties::bondOrders) {
+    writer.put(static_cast<std::uint32_t>(response.bondOrders.rows()));
+    writer.putDoubles(response.bondOrders.data(), response.bondOrders.size());
+  }
+  return std::move(writer.data());
+}
+
+CalculationResponse ServerProtocol::decodeResponse(const std::string& payload) {
+  Reader reader(payload);
+  CalculationResponse response;
+  response.success = reader.get<std::uint8_t>() != 0;
+  response.cached = reader.get<std::uint8_t>() != 0;
+  if (!response.success) {
+    response.error = reader.getString();
+    reader.finish();
+    return response;
+  }
+  response.properties = reader.get<std::uint32_t>();
+  response.energy = reader.get<double>();
+  if (response.properties & ServerProperties::gradients) {
+    response.gradients.resize(reader.get<std::uint32_t>(), 3);
+    reader.getDoubles(response.gradients.data(), response.gradients.size());
+  }
+  if (response.properties & ServerProperties::atomicCharges) {
+    response.atomicCharges = reader.getDoubles();
+  }
+  if (response.properties & ServerProperties::dipole) {
+    reader.getDoubles(response.dipole.data(), 3);
+  }
+  if (response.properties & ServerProperties::hessian) {
+    const auto n = reader.get<std::uint32_t>();
+    response.hessian.resize(n, n);
+    reader.getDoubles(response.hessian.data(), response.hessian.size());
+  }
+  if (response.properties & ServerProperties::bondOrders) {
+    const auto n = reader.get<std::uint32_t>();
+    response.bondOrders.resize(n, n);
+    reader.getDoubles(response.bondOrders.data(), response.bondOrders.size());
+  }
+  reader.finish();
+  return response;
+}
+
+void ServerProtocol::markCached(std::string& payload) {
+  if (payload.size() > 1) {
+    payload[1] = 1;
+  }
+}
+
+std::string ServerProtocol::sessionKey(const CalculationRequest& request) {
+  Writer writer;
+  writer.putString(request.method);
+  putElements(writer, request.structure.getElements());
+  putSettings(writer, request.settings);
+  return std::move(writer.data());
+}
+
+bool ServerProtocol::readFrame(int socket, std::string& payload) {
+  std::uint32_t size = 0;
+  const auto received = fullyReceive(socket, reinterpret_cast<char*>(&size), sizeof(size));
+  if (received == 0) {
+    return false;
+  }
+  if (received < sizeof(size)) {
+    throw std::runtime_error("The connection to the calculation server was closed within a message.");
+  }
+  if (size > maxFrameSize) {
+    throw std::runtime_error("The message of " + std::to_string(size) + " bytes exceeds the limit of the server.");
+  }
+  payload.resize(size);
+  if (fullyReceive(socket, &payload[0], size) < size) {
+    throw std::runtime_error("The connection to the calculation server was closed within a message.");
+  }
+  return true;
+}
+
+void ServerProtocol::writeFrame(int socket, const std::string& payload) {
+  if (payload.size() > maxFrameSize) {
+    throw std::runtime_error("The message of " + std::to_string(payload.size()) +
+                             " bytes exceeds the limit of the server.");
+  }
+  const auto size = static_cast<std::uint32_t>(payload.size());
+  fullySend(socket, reinterpret_cast<const char*>(&size), sizeof(size));
+  fullySend(socket, payload.data(), payload.size());
+}
+
+} /* namespace Xtb */
+} /* namespace Scine */
@@ -0,0 +1,107 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_SERVERPROTOCOL_H_
+#define XTB_SERVERPROTOCOL_H_
+
+/* External Includes */
+#include <Utils/Geometry/AtomCollection.h>
+#include <Utils/Typenames.h>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace Scine {
+namespace Xtb {
+
+/// @brief The properties a client can request in addition to the energy, combined as bit flags.
+namespace ServerProperties {
+static constexpr std::uint32_t gradients = 1u << 0;
+static constexpr std::uint32_t atomicCharges = 1u << 1;
+static constexpr std::uint32_t dipole = 1u << 2;
+static constexpr std::uint32_t hessian = 1u << 3;
+static constexpr std::uint32_t bondOrders = 1u << 4;
+} // namespace ServerProperties
+
+/// @brief The value of a calculator setting within a request.
+using ServerSettingValue = std::variant<int, double, bool, std::string, std::vector<double>>;
+
+/// @brief A calculation request of a client.
+struct CalculationRequest {
+  /// @brief One of GFN0, GFN1, GFN2 and GFNFF.
+  std::string method;
+  /// @brief The structure, the positions are in bohr.
+  Utils::AtomCollection structure;
+  /// @brief Settings of the calculator deviating from its defaults, e.g. the molecular charge.
+  std::vector<std::pair<std::string, ServerSettingValue>> settings;
+  /// @brief The requested properties, see ServerProperties.
+  std::uint32_t properties = 0;
+};
+
+/// @brief The answer of the server to a CalculationRequest.
+struct CalculationResponse {
+  bool success = false;
+  /// @brief Whether the results were served from the result cache.
+  bool cached = false;
+  /// @brief The error message of a failed calculation.
+  std::string error;
+  /// @brief The properties contained in addition to the energy, see ServerProperties.
+  std::uint32_t properties = 0;
+  double energy = 0.0;
+  Utils::GradientCollection gradients;
+  std::vector<double> atomicCharges;
+  Utils::Dipole dipole = Utils::Dipole::Zero();
+  Utils::HessianMatrix hessian;
+  /// @brief The dense Wiberg bond orders.
+  Eigen::MatrixXd bondOrders;
+};
+
+/**
+ * @class ServerProtocol
+ * @brief The wire format of the calculation server.
+ *
+ * Every message is a frame of a 32 bit length followed by the payload. All
+ * numbers are in the native byte order, since server and clients share the
+ * node. Strings and lists are prefixed with their 32 bit length, elements are
+ * sent as their atomic numbers.
+ */
+class ServerProtocol {
+ public:
+  /// @brief The version of the wire format, the first byte of every request.
+  static constexpr std::uint8_t version = 1;
+  /// @brief The largest accepted frame in bytes.
+  static constexpr std::uint32_t maxFrameSize = 256u * 1024 * 1024;
+
+  static std::string encodeRequest(const CalculationRequest& request);
+  static CalculationRequest decodeRequest(const std::string& payload);
+  static std::string encodeResponse(const CalculationResponse& response);
+  static CalculationResponse decodeResponse(const std::string& payload);
+  /**
+   * @brief Marks an encoded response as served from the cache, without
+   *        decoding it.
+   */
+  static void markCached(std::string& payload);
+  /**
+   * @brief Everything of a request except for the positions and the
+   *        requested properties, requests with the same key can share a
+   *        session.
+   */
+  static std::string sessionKey(const CalculationRequest& request);
+  /**
+   * @brief Reads one frame from a connected socket.
+   * @return bool False if the peer closed the connection before the frame started.
+   */
+  static bool readFrame(int socket, std::string& payload);
+  /// @brief Writes one frame to a connected socket.
+  static void writeFrame(int socket, const std::string& payload);
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_SERVERPROTOCOL_H_ */
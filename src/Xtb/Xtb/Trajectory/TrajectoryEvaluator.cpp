@@ -0,0 +1,243 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Trajectory/TrajectoryEvaluator.h"
+#include "Xtb/Wrapper/XtbCalculatorBase.h"
+#include "Xtb/Wrapper/XtbSession.h"
+/* External Includes */
+#include <Utils/Constants.h>
+#include <Utils/Geometry/ElementInfo.h>
+#include <Utils/UniversalSettings/SettingsNames.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace Scine {
+namespace Xtb {
+
+TrajectoryEvaluator::TrajectoryEvaluator(const XtbCalculatorBase& calculator) : _calculator(calculator) {
+}
+
+Utils::Settings& TrajectoryEvaluator::settings() {
+  return _settings;
+}
+
+const Utils::Settings& TrajectoryEvaluator::settings() const {
+  return _settings;
+}
+
+int TrajectoryEvaluator::evaluate(std::istream& input, const ResultSink& sink) {
+  namespace Names = TrajectoryEvaluatorSettingsNames;
+  if (!_settings.valid()) {
+    _settings.throwIncorrectSettings();
+  }
+  const bool binary = _settings.getString(Names::inputFormat) == "binary";
+  const int nWorkers = _settings.getInt(Names::numberOfWorkers);
+  const int threadsPerWorker = _settings.getInt(Names::threadsPerWorker);
+  const int maxFramesInFlight = _settings.getInt(Names::maxFramesInFlight);
+
+  std::mutex mutex;
+  std::condition_variable frameAvailable;
+  std::condition_variable resultAvailable;
+  std::deque<std::pair<int, Utils::AtomCollection>> frames;
+  std::map<int, Utils::Results> finished;
+  bool endOfInput = false;
+
+  auto work = [&]() {
+    auto calculator = _calculator.clone();
+    calculator->settings().modifyInt(Utils::SettingsNames::externalProgramNProcs, threadsPerWorker);
+    std::unique_ptr<XtbSession> session;
+    while (true) {
+      std::unique_lock<std::mutex> lock(mutex);
+      frameAvailable.wait(lock, [&] { return !frames.empty() || endOfInput; });
+      if (frames.empty()) {
+        return;
+      }
+      auto frame = std::move(frames.front());
+      frames.pop_front();
+      lock.unlock();
+
+      Utils::Results results;
+      try {
+        // Keep the session (and its wavefunction) as long as the elements are unchanged
+        if (session && calculator->getStructure()->getElements() == frame.second.getElements()) {
+          calculator->modifyPositions(frame.second.getPositions());
+        }
+        else {
+          session.reset();
+          calculator->setStructure(frame.second);
+          session = calculator->createSession();
+        }
+        results = calculator->calculate(*session);
+      }
+      catch (...) {
+        // A failed SCF may leave the wavefunction in an unusable state
+        session.reset();
+        results = Utils::Results();
+        results.set<Utils::Property::SuccessfulCalculation>(false);
+      }
+
+      lock.lock();
+      finished.emplace(frame.first, std::move(results));
+      lock.unlock();
+      resultAvailable.notify_one();
+    }
+  };
+  std::vector<std::thread> workers;
+  for (int i = 0; i < nWorkers; ++i) {
+    workers.emplace_back(work);
+  }
+
+  // Read frames and pass on results in input order, keeping the number of frames in memory bounded
+  int nRead = 0;
+  int nWritten = 0;
+  bool endOfStream = false;
+  std::exception_ptr error = nullptr;
+  std::unique_lock<std::mutex> lock(mutex);
+  while (!endOfStream || nWritten < nRead) {
+    auto next = finished.find(nWritten);
+    if (next != finished.end()) {
+      Utils::Results results = std::move(next->second);
+      finished.erase(next);
+      lock.unlock();
+      try {
+        sink(nWritten, results);
+      }
+      catch (...) {
+        error = std::current_exception();
+      }
+      lock.lock();
+      ++nWritten;
+      if (error) {
+        break;
+      }
+    }
+    else if (!endOfStream && nRead - nWritten < maxFramesInFlight) {
+      lock.unlock();
+      Utils::AtomCollection frame;
+      try {
+        endOfStream = binary ? !readBinaryFrame(input, frame) : !readXyzFrame(input, frame);
+      }
+      catch (...) {
+        error = std::current_exception();
+      }
+      lock.lock();
+      if (error) {
+        break;
+      }
+      if (!endOfStream) {
+        frames.emplace_back(nRead++, std::move(frame));
+        frameAvailable.notify_one();
+      }
+    }
+    else {
+      resultAvailable.wait(lock, [&] { return finished.count(nWritten) > 0; });
+    }
+  }
+  endOfInput = true;
+  frames.clear();
+  lock.unlock();
+  frameAvailable.notify_all();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return nWritten;
+}
+
+int TrajectoryEvaluator::evaluate(std::istream& input, std::ostream& output) {
+  return evaluate(input, [&output](int index, const Utils::Results& results) {
+    std::ostringstream block;
+    block << std::setprecision(12);
+    if (!results.has<Utils::Property::SuccessfulCalculation>() ||
+        !results.get<Utils::Property::SuccessfulCalculation>()) {
+      block << index << " failed\n";
+    }
+    else {
+      block << index << " " << results.get<Utils::Property::Energy>() << "\n";
+      if (results.has<Utils::Property::Gradients>()) {
+        const auto& gradients = results.get<Utils::Property::Gradients>();
+        for (int i = 0; i < gradients.rows(); ++i) {
+          block << gradients(i, 0) << " " << gradients(i, 1) << " " << gradients(i, 2) << "\n";
+        }
+      }
+    }
+    output << block.str();
+  });
+}
+
+bool TrajectoryEvaluator::readXyzFrame(std::istream& input, Utils::AtomCollection& frame) {
+  std::string line;
+  // Skip empty lines between frames
+  do {
+    if (!std::getline(input, line)) {
+      return false;
+    }
+  } while (line.find_first_not_of(" \t\r") == std::string::npos);
+  int nAtoms = 0;
+  std::istringstream(line) >> nAtoms;
+  if (nAtoms <= 0 || !std::getline(input, line)) {
+    throw std::runtime_error("Invalid XYZ frame header: '" + line + "'.");
+  }
+  Utils::ElementTypeCollection elements(nAtoms);
+  Utils::PositionCollection positions(nAtoms, 3);
+  for (int i = 0; i < nAtoms; ++i) {
+    std::string symbol;
+    if (!std::getline(input, line) ||
+        !(std::istringstream(line) >> symbol >> positions(i, 0) >> positions(i, 1) >> positions(i, 2))) {
+      throw std::runtime_error("Truncated or invalid XYZ frame.");
+    }
+    elements[i] = Utils::ElementInfo::elementTypeForSymbol(symbol);
+  }
+  frame = Utils::AtomCollection(elements, positions * Utils::Constants::bohr_per_angstrom);
+  return true;
+}
+
+bool TrajectoryEvaluator::readBinaryFrame(std::istream& input, Utils::AtomCollection& frame) {
+  std::int32_t nAtoms = 0;
+  if (!input.read(reinterpret_cast<char*>(&nAtoms), sizeof(nAtoms))) {
+    return false;
+  }
+  if (nAtoms <= 0) {
+    throw std::runtime_error("Invalid number of atoms in binary frame.");
+  }
+  std::vector<std::int32_t> atomicNumbers(nAtoms);
+  Utils::PositionCollection positions(nAtoms, 3);
+  input.read(reinterpret_cast<char*>(atomicNumbers.data()), nAtoms * sizeof(std::int32_t));
+  input.read(reinterpret_cast<char*>(positions.data()), 3 * nAtoms * sizeof(double));
+  if (!input) {
+    throw std::runtime_error("Truncated binary frame.");
+  }
+  Utils::ElementTypeCollection elements(nAtoms);
+  for (int i = 0; i < nAtoms; ++i) {
+    elements[i] = Utils::ElementInfo::element(static_cast<unsigned>(atomicNumbers[i]));
+  }
+  frame = Utils::AtomCollection(elements, positions);
+  return true;
+}
+
+void TrajectoryEvaluator::writeBinaryFrame(std::ostream& output, const Utils::AtomCollection& frame) {
+  const auto nAtoms = static_cast<std::int32_t>(frame.size());
+  std::vector<std::int32_t> atomicNumbers(nAtoms);
+  for (int i = 0; i < nAtoms; ++i) {
+    atomicNumbers[i] = Utils::ElementInfo::Z(frame.getElement(i));
+  }
+  output.write(reinterpret_cast<const char*>(&nAtoms), sizeof(nAtoms));
+  output.write(reinterpret_cast<const char*>(atomicNumbers.data()), nAtoms * sizeof(std::int32_t));
+  output.write(reinterpret_cast<const char*>(frame.getPositions().data()), 3 * nAtoms * sizeof(double));
+}
+
+} /* namespace Xtb */
+} /* namespace Scine */
@@ -0,0 +1,98 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_TRAJECTORYEVALUATOR_H_
+#define XTB_TRAJECTORYEVALUATOR_H_
+
+/* Internal Includes */
+#include "Xtb/Trajectory/TrajectoryEvaluatorSettings.h"
+/* External Includes */
+#include <Utils/CalculatorBasics.h>
+#include <Utils/Geometry/AtomCollection.h>
+#include <functional>
+#include <istream>
+#include <ostream>
+
+namespace Scine {
+namespace Xtb {
+
+class XtbCalculatorBase;
+
+/**
+ * @class TrajectoryEvaluator
+ * @brief Streaming evaluation of multi-frame trajectories.
+ *
+ * Frames are read incrementally from an input stream and evaluated by a set of
+ * workers, each of which owns a clone of the calculator and a persistent xtb
+ * session that is reused as long as the elements of the frames do not change.
+ * The number of frames held in memory is bounded, and the results are passed
+ * on in the order of the input.
+ *
+ * The binary frame format is a sequence of frames, each consisting of the
+ * number of atoms (int32), the atomic numbers (int32 each) and the Cartesian
+ * coordinates in bohr (double each, atom-major), all in native byte order.
+ */
+class TrajectoryEvaluator {
+ public:
+  /// @brief The sink is called with the frame index and its results, in input order.
+  using ResultSink = std::function<void(int, const Utils::Results&)>;
+  /**
+   * @brief Constructor.
+   * @param calculator The calculator defining the method, its settings and the
+   *                   required properties, it is cloned for each worker.
+   */
+  explicit TrajectoryEvaluator(const XtbCalculatorBase& calculator);
+  /// @brief Accessor for the settings of the evaluation.
+  Utils::Settings& settings();
+  /// @brief Const accessor for the settings of the evaluation.
+  const Utils::Settings& settings() const;
+  /**
+   * @brief Evaluates all frames of the input.
+   *
+   * Failed frames are reported with Utils::Property::SuccessfulCalculation set
+   * to false instead of stopping the evaluation.
+   *
+   * @param input The stream of frames.
+   * @param sink  The sink of the results.
+   * @return int The number of evaluated frames.
+   */
+  int evaluate(std::istream& input, const ResultSink& sink);
+  /**
+   * @brief Evaluates all frames of the input and writes the results as text.
+   *
+   * For each frame, a line with the frame index and the energy (or 'failed')
+   * is written, followed by one line per atom with the gradient if it was
+   * required.
+   *
+   * @param input  The stream of frames.
+   * @param output The stream the results are written to.
+   * @return int The number of evaluated frames.
+   */
+  int evaluate(std::istream& input, std::ostream& output);
+  /**
+   * @brief Reads the next frame of a concatenated XYZ stream.
+   * @return bool False if the end of the stream was reached.
+   */
+  static bool readXyzFrame(std::istream& input, Utils::AtomCollection& frame);
+  /**
+   * @brief Reads the next frame of a binary frame stream.
+   * @return bool False if the end of the stream was reached.
+   */
+  static bool readBinaryFrame(std::istream& input, Utils::AtomCollection& frame);
+  /**
+   * @brief Appends a frame to a binary frame stream.
+   */
+  static void writeBinaryFrame(std::ostream& output, const Utils::AtomCollection& frame);
+
+ private:
+  const XtbCalculatorBase& _calculator;
+  TrajectoryEvaluatorSettings _settings;
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_TRAJECTORYEVALUATOR_H_ */
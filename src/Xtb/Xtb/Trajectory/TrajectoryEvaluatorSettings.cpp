@@ -0,0 +1,48 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Trajectory/TrajectoryEvaluatorSettings.h"
+
+namespace Scine {
+namespace Xtb {
+
+TrajectoryEvaluatorSettings::TrajectoryEvaluatorSettings() : Scine::Utils::Settings("TrajectoryEvaluatorSettings") {
+  using namespace Scine::Utils::UniversalSettings;
+  namespace Names = TrajectoryEvaluatorSettingsNames;
+
+  // Input format
+  OptionListDescriptor inputFormat("The format of the frames, 'xyz' for concatenated XYZ files (in angstrom) or "
+                                   "'binary' for the binary frame format (in bohr).");
+  inputFormat.addOption("xyz");
+  inputFormat.addOption("binary");
+  inputFormat.setDefaultOption("xyz");
+  this->_fields.push_back(Names::inputFormat, inputFormat);
+
+  // Workers
+  IntDescriptor numberOfWorkers("The number of frames evaluated concurrently.");
+  numberOfWorkers.setMinimum(1);
+  numberOfWorkers.setDefaultValue(1);
+  this->_fields.push_back(Names::numberOfWorkers, numberOfWorkers);
+
+  IntDescriptor threadsPerWorker("The number of OpenMP threads used by xtb in each worker.");
+  threadsPerWorker.setMinimum(1);
+  threadsPerWorker.setDefaultValue(1);
+  this->_fields.push_back(Names::threadsPerWorker, threadsPerWorker);
+
+  // Memory bound
+  IntDescriptor maxFramesInFlight("The maximum number of frames that have been read but whose results have not yet "
+                                  "been written. This bounds the memory of the evaluation.");
+  maxFramesInFlight.setMinimum(1);
+  maxFramesInFlight.setDefaultValue(64);
+  this->_fields.push_back(Names::maxFramesInFlight, maxFramesInFlight);
+
+  this->resetToDefaults();
+}
+
+} /* namespace Xtb */
+} /* namespace Scine */
@@ -0,0 +1,38 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_TRAJECTORYEVALUATORSETTINGS_H_
+#define XTB_TRAJECTORYEVALUATORSETTINGS_H_
+
+/* External Includes */
+#include <Utils/Settings.h>
+
+namespace Scine {
+namespace Xtb {
+
+namespace TrajectoryEvaluatorSettingsNames {
+static constexpr const char* inputFormat = "input_format";
+static constexpr const char* numberOfWorkers = "number_of_workers";
+static constexpr const char* threadsPerWorker = "threads_per_worker";
+static constexpr const char* maxFramesInFlight = "max_frames_in_flight";
+} // namespace TrajectoryEvaluatorSettingsNames
+
+/**
+ * @class TrajectoryEvaluatorSettings
+ * @brief The settings of the streaming trajectory evaluation.
+ */
+class TrajectoryEvaluatorSettings : public Scine::Utils::Settings {
+ public:
+  /**
+   * @brief Construct a new TrajectoryEvaluatorSettings object.
+   */
+  TrajectoryEvaluatorSettings();
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_TRAJECTORYEVALUATORSETTINGS_H_ */
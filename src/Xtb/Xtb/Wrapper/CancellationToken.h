@@ -0,0 +1,54 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_CANCELLATIONTOKEN_H_
+#define XTB_CANCELLATIONTOKEN_H_
+
+/* External Includes */
+#include <Core/Exceptions.h>
+#include <atomic>
+#include <string>
+
+namespace Scine {
+namespace Xtb {
+
+/**
+ * @class CancellationToken
+ * @brief A flag to cancel running calculations from another thread.
+ *
+ * The token is shared between a calculator and its clones, such that
+ * cancelling it stops all calculations derived from the calculator.
+ */
+class CancellationToken {
+ public:
+  /// @brief Requests all calculations observing this token to stop.
+  void cancel() {
+    _cancelled.store(true);
+  }
+  /// @brief Whether the cancellation was requested.
+  bool isCancelled() const {
+    return _cancelled.load();
+  }
+
+ private:
+  std::atomic<bool> _cancelled{false};
+};
+
+/**
+ * @class CalculationCancelledException
+ * @brief Thrown if a calculation was cancelled or exceeded its time limit.
+ */
+class CalculationCancelledException : public Core::UnsuccessfulCalculationException {
+ public:
+  explicit CalculationCancelledException(const std::string& message)
+    : Core::UnsuccessfulCalculationException(message) {
+  }
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_CANCELLATIONTOKEN_H_ */
@@ -48,7 +48,8 @@ class GFN0Wrapper : public Scine::Utils::CloneInterface<GFN0Wrapper, XtbCalculat
    */
   Scine::Utils::PropertyList possibleProperties() const final {
     return Utils::Property::Energy | Utils::Property::Gradients | Utils::Property::Hessian |
-           Utils::Property::SuccessfulCalculation | Utils::Property::Thermochemistry;
+           Utils::Property::SuccessfulCalculation | Utils::Property::Thermochemistry | Utils::Property::StressTensor |
+           Utils::Property::Dipole | Utils::Property::OrbitalEnergies;
   };
   /**
    * @brief Check if the method family is supported by this calculator.
@@ -60,13 +61,20 @@ class GFN0Wrapper : public Scine::Utils::CloneInterface<GFN0Wrapper, XtbCalculat
     return methodFamily == "GFN0";
   }
   /**
-   * @brief Run the calculation.
-   * @param dummy
-   * @return const Scine::Utils::Results& The results.
+   * @brief Report the implicit solvents the method is parametrized for.
+   * @return std::vector<std::string> The lower case solvent names.
    */
-  virtual const Scine::Utils::Results& calculate(std::string dummy) final;
+  std::vector<std::string> availableSolvents() const final;
+  /**
+   * @brief Whether the method can be applied with periodic boundary conditions.
+   */
+  bool supportsPeriodicBoundaries() const final {
+    return true;
+  }
 
  private:
+  void _loadMethod(XtbSession& session) final;
+  double _estimateMethodMemory(int nAtoms, int nAos) const final;
   static std::mutex _mtx;
 };
 
@@ -49,7 +49,8 @@ class GFN1Wrapper : public Scine::Utils::CloneInterface<GFN1Wrapper, XtbCalculat
   Scine::Utils::PropertyList possibleProperties() const final {
     return Utils::Property::Energy | Utils::Property::AtomicCharges | Utils::Property::Gradients |
            Utils::Property::Hessian | Utils::Property::BondOrderMatrix | Utils::Property::SuccessfulCalculation |
-           Utils::Property::Thermochemistry | Utils::Property::PointChargesGradients;
+           Utils::Property::Thermochemistry | Utils::Property::PointChargesGradients |
+           Utils::Property::StressTensor | Utils::Property::Dipole | Utils::Property::OrbitalEnergies;
   };
   /**
    * @brief Check if the method family is supported by this calculator.
@@ -61,13 +62,20 @@ class GFN1Wrapper : public Scine::Utils::CloneInterface<GFN1Wrapper, XtbCalculat
     return methodFamily == "GFN1";
   }
   /**
-   * @brief Run the calculation.
-   * @param dummy
-   * @return const Scine::Utils::Results& The results.
+   * @brief Report the implicit solvents the method is parametrized for.
+   * @return std::vector<std::string> The lower case solvent names.
    */
-  virtual const Scine::Utils::Results& calculate(std::string dummy) final;
+  std::vector<std::string> availableSolvents() const final;
+  /**
+   * @brief Whether the method can be applied with periodic boundary conditions.
+   */
+  bool supportsPeriodicBoundaries() const final {
+    return true;
+  }
 
  private:
+  void _loadMethod(XtbSession& session) final;
+  double _estimateMethodMemory(int nAtoms, int nAos) const final;
   static std::mutex _mtx;
 };
 
@@ -0,0 +1,79 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_LOCKSTATISTICS_H_
+#define XTB_LOCKSTATISTICS_H_
+
+/* External Includes */
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace Scine {
+namespace Xtb {
+
+/**
+ * @class LockStatistics
+ * @brief Counts the acquisitions of a mutex, how often it was contended, and
+ *        the total time spent waiting for it.
+ *
+ * An uncontended acquisition costs one additional try_lock and two atomic
+ * increments, so the statistics are always enabled.
+ */
+class LockStatistics {
+ public:
+  /// @brief A consistent copy of the counters.
+  struct Snapshot {
+    std::uint64_t acquisitions = 0;
+    std::uint64_t contentions = 0;
+    /// @brief The total time spent waiting for the mutex in seconds.
+    double waitTime = 0.0;
+  };
+  /**
+   * @brief Locks the given mutex and records the acquisition.
+   * @param mutex The mutex guarded by these statistics.
+   * @return std::unique_lock<std::mutex> The owning lock.
+   */
+  std::unique_lock<std::mutex> lock(std::mutex& mutex) {
+    std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+      const auto start = std::chrono::steady_clock::now();
+      lock.lock();
+      const auto wait = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+      _contentions.fetch_add(1, std::memory_order_relaxed);
+      _waitNanoseconds.fetch_add(static_cast<std::uint64_t>(wait.count()), std::memory_order_relaxed);
+    }
+    _acquisitions.fetch_add(1, std::memory_order_relaxed);
+    return lock;
+  }
+  /// @brief The current counters.
+  Snapshot snapshot() const {
+    Snapshot snapshot;
+    snapshot.acquisitions = _acquisitions.load();
+    snapshot.contentions = _contentions.load();
+    snapshot.waitTime = 1e-9 * static_cast<double>(_waitNanoseconds.load());
+    return snapshot;
+  }
+  /**
+   * @brief The statistics of the mutexes serializing the parameter loading of
+   *        the xtb methods, shared by all wrappers.
+   */
+  static LockStatistics& methodLoading() {
+    static LockStatistics statistics;
+    return statistics;
+  }
+
+ private:
+  std::atomic<std::uint64_t> _acquisitions{0};
+  std::atomic<std::uint64_t> _contentions{0};
+  std::atomic<std::uint64_t> _waitNanoseconds{0};
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_LOCKSTATISTICS_H_ */
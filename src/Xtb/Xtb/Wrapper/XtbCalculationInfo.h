@@ -0,0 +1,62 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_XTBCALCULATIONINFO_H_
+#define XTB_XTBCALCULATIONINFO_H_
+
+/* External Includes */
+#include <Utils/CalculatorBasics.h>
+#include <Eigen/Core>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Scine {
+namespace Xtb {
+
+/**
+ * @struct ScfAttempt
+ * @brief One attempt of the SCF convergence recovery.
+ */
+struct ScfAttempt {
+  /// @brief The electronic temperature in kelvin.
+  double electronicTemperature = 0.0;
+  int maxIterations = 0;
+  bool converged = false;
+  /// @brief The error of xtb if the attempt failed.
+  std::string message;
+};
+
+/**
+ * @struct XtbCalculationInfo
+ * @brief Additional information on the last calculation of an xtb calculator
+ *        that has no counterpart in Utils::Results.
+ */
+struct XtbCalculationInfo {
+  /// @brief The estimated peak memory of the calculation in bytes.
+  std::size_t estimatedMemory = 0;
+  /// @brief The peak resident memory of the whole process after the calculation in bytes, 0 if unknown.
+  std::size_t peakResidentMemory = 0;
+  /// @brief The required properties that were skipped in order to stay within the memory limit.
+  Utils::PropertyList skippedProperties;
+  /// @brief The Fermi smeared occupation numbers of the orbitals (between 0 and 2), empty for force fields.
+  Eigen::VectorXd orbitalOccupations;
+  /// @brief The HOMO-LUMO gap in hartree, 0 for force fields.
+  double homoLumoGap = 0.0;
+  /// @brief The number of gradient evaluations of the numerical Hessian, 0 if no Hessian was calculated.
+  int hessianGradientEvaluations = 0;
+  /// @brief The number of consecutive updates of the Hessian, 0 if it was calculated exactly.
+  int hessianUpdates = 0;
+  /// @brief The captured output of xtb, empty unless the output_mode setting is 'capture'.
+  std::string output;
+  /// @brief The SCF attempts of the convergence recovery, empty if it is disabled.
+  std::vector<ScfAttempt> scfAttempts;
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_XTBCALCULATIONINFO_H_ */
@@ -7,18 +7,75 @@
 
 /* Internal Includes */
 #include "Xtb/Wrapper/XtbCalculatorBase.h"
+#include "Xtb/Hessian/SymmetryDetector.h"
+#include "Xtb/Wrapper/GFN0Wrapper.h"
+#include "Xtb/Wrapper/GFN1Wrapper.h"
+#include "Xtb/Wrapper/GFN2Wrapper.h"
+#include "Xtb/Wrapper/GFNFFWrapper.h"
+#include "Xtb/Wrapper/XtbRestartFile.h"
 #include "Xtb/Wrapper/XtbState.h"
+/* External Includes */
+#include <Utils/Bonds/BondOrderCollection.h>
+#include <Utils/CalculatorBasics/ResultsAutoCompleter.h>
+#include <Utils/Geometry/ElementInfo.h>
+#include <Utils/Geometry/PeriodicBoundaries.h>
+#include <Utils/DataStructures/SingleParticleEnergies.h>
+#include <Utils/Scf/LcaoUtils/ElectronicOccupation.h>
+#include <Utils/Solvation/ImplicitSolvation.h>
+#include <Eigen/LU>
+#include <Eigen/QR>
 #include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <cmath>
+#include <exception>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
 #include <string>
+#if defined(_OPENMP)
+#  include <omp.h>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#  include <sys/resource.h>
+#endif
 
 namespace Scine {
 namespace Xtb {
 
+std::shared_ptr<XtbCalculatorBase> XtbCalculatorBase::create(const std::string& method) {
+  if (method == GFN0Wrapper::model) {
+    return std::make_shared<GFN0Wrapper>();
+  }
+  if (method == GFN1Wrapper::model) {
+    return std::make_shared<GFN1Wrapper>();
+  }
+  if (method == GFN2Wrapper::model) {
+    return std::make_shared<GFN2Wrapper>();
+  }
+  if (method == GFNFFWrapper::model) {
+    return std::make_shared<GFNFFWrapper>();
+  }
+  throw std::runtime_error("There is no xtb calculator for the method '" + method + "'.");
+}
+
 XtbCalculatorBase::XtbCalculatorBase(const XtbCalculatorBase& other) : CloneInterface(other) {
   _settings = other._settings;
   _results = other._results;
   _requiredProperties = other._requiredProperties;
+  _calculatedProperties = other._calculatedProperties;
+  _calculationInfo = other._calculationInfo;
+  _cancellationToken = other._cancellationToken;
+  _validatedSettings = other._validatedSettings;
+  _validatedElements = other._validatedElements;
+  _settingsGeneration = other._settingsGeneration;
+  _outputSink = other._outputSink;
+  _lastHessian = other._lastHessian;
+  _lastHessianElements = other._lastHessianElements;
+  _lastHessianPositions = other._lastHessianPositions;
+  _lastHessianGradients = other._lastHessianGradients;
+  _lastHessianGeneration = other._lastHessianGeneration;
+  _hessianUpdates = other._hessianUpdates;
   if (other._structure) {
     _structure = std::make_unique<Scine::Utils::AtomCollection>(*(other._structure));
   }
@@ -107,19 +164,17 @@ void XtbCalculatorBase::verifyPesValidity() {
   _settings.modifyString(Utils::SettingsNames::method, model);
 
   // get n electrons for uncharged species and available AOs
-  int nElectrons = 0;
-  int nAos = 0;
-  for (int i = 0; i < _structure->size(); ++i) {
-    const auto ele = _structure->getElement(i);
-    // check if bigger element number than the last included one
-    if (Utils::ElementInfo::Z(ele) > Utils::ElementInfo::Z(_nElectronsAndAos.rbegin()->first)) {
-      throw std::runtime_error(
-          "XTB: The structure includes an element that is not supported by the GFN-X method family.");
-    }
-    auto parameters = _nElectronsAndAos.at(ele);
-    nElectrons += parameters.first;
-    nAos += parameters.second;
+  const auto& elements = _structure->getElements();
+  if (_counts.elements != elements || elements.empty()) {
+    _counts = _countElectronsAndAos(elements);
   }
+  const auto& counts = _counts;
+  if (!counts.supported) {
+    throw std::runtime_error(
+        "XTB: The structure includes an element that is not supported by the GFN-X method family.");
+  }
+  int nElectrons = counts.valenceElectrons;
+  const int nAos = counts.nAos;
 
   // check charge
   if (charge > nElectrons) {
@@ -149,14 +204,758 @@ void XtbCalculatorBase::verifyPesValidity() {
   }
 }
 
-void XtbCalculatorBase::setExternalCharges(xtb_TEnvironment& env, xtb_TCalculator& calc, xtb_TResults& res, xtb_TMolecule& mol) {
+std::size_t XtbCalculatorBase::estimateMemory(const Utils::AtomCollection& structure,
+                                              const Utils::PropertyList& properties) const {
+  const int nAtoms = structure.size();
+  const int nAos = _countElectronsAndAos(structure.getElements()).nAos;
+  const double doubleSize = sizeof(double);
+  // Parametrization and Fortran runtime of xtb
+  const double overhead = 32.0 * 1024 * 1024;
+  const double method = _estimateMethodMemory(nAtoms, nAos);
+  double memory = overhead + method;
+  // Results, the structure and the gradients
+  memory += 4.0 * nAtoms * 3 * doubleSize;
+  if (properties.containsSubSet(Utils::Property::BondOrderMatrix)) {
+    // Dense Wiberg bond orders of xtb and their sparse copy
+    memory += 2.0 * nAtoms * nAtoms * doubleSize;
+  }
+  if (properties.containsSubSet(Utils::Property::Hessian) ||
+      properties.containsSubSet(Utils::Property::Thermochemistry)) {
+    // The Hessian, its mass-weighted copy and the normal mode analysis, the
+    // displacements are run within the same session
+    const double dimension = 3.0 * nAtoms;
+    memory += 4.0 * dimension * dimension * doubleSize;
+  }
+  return static_cast<std::size_t>(memory);
+}
+
+void XtbCalculatorBase::setCancellationToken(std::shared_ptr<CancellationToken> token) {
+  _cancellationToken = std::move(token);
+}
+
+void XtbCalculatorBase::setOutputSink(OutputSink sink) {
+  _outputSink = std::move(sink);
+}
+
+std::shared_ptr<CancellationToken> XtbCalculatorBase::getCancellationToken() const {
+  return _cancellationToken;
+}
+
+void XtbCalculatorBase::checkCancellation() const {
+  if (_cancellationToken && _cancellationToken->isCancelled()) {
+    throw CalculationCancelledException("The " + name() + " calculation was cancelled.");
+  }
+  if (_hasDeadline && std::chrono::steady_clock::now() > _deadline) {
+    throw CalculationCancelledException("The " + name() + " calculation exceeded its time limit.");
+  }
+}
+
+void XtbCalculatorBase::_startClock() {
+  const double timeLimit = _settings.getDouble(XtbSettingsNames::timeLimit);
+  _hasDeadline = timeLimit > 0.0;
+  if (_hasDeadline) {
+    const std::chrono::duration<double> duration(timeLimit);
+    using Duration = std::chrono::steady_clock::duration;
+    _deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<Duration>(duration);
+  }
+}
+
+const XtbCalculationInfo& XtbCalculatorBase::calculationInfo() const {
+  return _calculationInfo;
+}
+
+void XtbCalculatorBase::resetHessianUpdates() {
+  _lastHessian.resize(0, 0);
+  _hessianUpdates = 0;
+}
+
+void XtbCalculatorBase::_applyMemoryLimit() {
+  _calculatedProperties = _requiredProperties;
+  _calculationInfo = XtbCalculationInfo();
+  _calculationInfo.estimatedMemory = estimateMemory(*_structure, _calculatedProperties);
+  const std::size_t limit = static_cast<std::size_t>(_settings.getInt(XtbSettingsNames::memoryLimit)) * 1024 * 1024;
+  if (limit == 0 || _calculationInfo.estimatedMemory <= limit) {
+    return;
+  }
+  if (_settings.getString(XtbSettingsNames::memoryLimitPolicy) == "downgrade") {
+    // Skip the most memory intensive properties first
+    const std::vector<std::vector<Utils::Property>> skippable = {
+        {Utils::Property::Hessian, Utils::Property::Thermochemistry}, {Utils::Property::BondOrderMatrix}};
+    for (const auto& properties : skippable) {
+      for (const auto& property : properties) {
+        if (_calculatedProperties.containsSubSet(property)) {
+          _calculatedProperties.removeProperty(property);
+          _calculationInfo.skippedProperties.addProperty(property);
+        }
+      }
+      _calculationInfo.estimatedMemory = estimateMemory(*_structure, _calculatedProperties);
+      if (_calculationInfo.estimatedMemory <= limit) {
+        return;
+      }
+    }
+  }
+  throw std::runtime_error("XTB: The estimated memory of " +
+                           std::to_string(_calculationInfo.estimatedMemory / (1024 * 1024)) +
+                           " MiB exceeds the memory limit of " + std::to_string(limit / (1024 * 1024)) + " MiB.");
+}
+
+int XtbCalculatorBase::_numberOfElectrons() const {
+  const auto& elements = _structure->getElements();
+  const int valenceElectrons =
+      _counts.elements == elements ? _counts.valenceElectrons : _countElectronsAndAos(elements).valenceElectrons;
+  return valenceElectrons - _settings.getInt(Utils::SettingsNames::molecularCharge);
+}
+
+XtbCalculatorBase::ElectronAndAoCounts
+XtbCalculatorBase::_countElectronsAndAos(const Utils::ElementTypeCollection& elements) const {
+  ElectronAndAoCounts counts;
+  const int maxZ = Utils::ElementInfo::Z(_nElectronsAndAos.rbegin()->first);
+  for (const auto& element : elements) {
+    auto parameters = _nElectronsAndAos.find(element);
+    if (parameters == _nElectronsAndAos.end() || Utils::ElementInfo::Z(element) > maxZ) {
+      // Estimate for unsupported elements
+      counts.supported = false;
+      counts.nAos += 9;
+      continue;
+    }
+    counts.valenceElectrons += parameters->second.first;
+    counts.nAos += parameters->second.second;
+  }
+  counts.elements = elements;
+  return counts;
+}
+
+Utils::HessianMatrix XtbCalculatorBase::_calculateHessian(XtbSession& session) {
+  // Step of Utils::NumericalHessianCalculator
+  const double delta = 1e-2;
+  const bool central = _settings.getString(XtbSettingsNames::hessianDifferences) == "central";
+  const Utils::PositionCollection reference = _structure->getPositions();
+  const int nAtoms = reference.rows();
+  const int dimension = 3 * nAtoms;
+  // The last single point of the session is the one of the reference positions
+  const Utils::GradientCollection referenceGradients = central ? Utils::GradientCollection() : session.getGradients();
+  _calculationInfo.hessianGradientEvaluations = 0;
+
+  // Point charges and periodic cells break the point group symmetry
+  std::vector<SymmetryOperation> operations;
+  if (_settings.getBool(XtbSettingsNames::hessianSymmetry) && !session.isPeriodic() && !session.hasExternalCharges()) {
+    operations = SymmetryDetector::detect(*_structure, _settings.getDouble(XtbSettingsNames::hessianSymmetryTolerance));
+  }
+  else {
+    SymmetryOperation identity;
+    identity.matrix = Eigen::Matrix3d::Identity();
+    identity.permutation.resize(nAtoms);
+    std::iota(identity.permutation.begin(), identity.permutation.end(), 0);
+    operations.push_back(identity);
+  }
+
+  // The Hessian column of a displacement of one atom along a unit direction
+  Utils::PositionCollection displaced = reference;
+  auto column = [&](int atom, const Eigen::Vector3d& direction) -> Eigen::VectorXd {
+    checkCancellation();
+    displaced.row(atom) = reference.row(atom) + delta * direction.transpose();
+    session.updatePositions(displaced);
+    session.singlepoint();
+    const Utils::GradientCollection plus = session.getGradients();
+    ++_calculationInfo.hessianGradientEvaluations;
+    // Gradient collections are row-major, i.e. ordered as the Hessian
+    Eigen::VectorXd result = Eigen::Map<const Eigen::VectorXd>(plus.data(), dimension);
+    if (central) {
+      displaced.row(atom) = reference.row(atom) - delta * direction.transpose();
+      session.updatePositions(displaced);
+      session.singlepoint();
+      const Utils::GradientCollection minus = session.getGradients();
+      ++_calculationInfo.hessianGradientEvaluations;
+      result = (result - Eigen::Map<const Eigen::VectorXd>(minus.data(), dimension)) / (2.0 * delta);
+    }
+    else {
+      result = (result - Eigen::Map<const Eigen::VectorXd>(referenceGradients.data(), dimension)) / delta;
+    }
+    displaced.row(atom) = reference.row(atom);
+    return result;
+  };
+
+  // Each symmetry-unique atom is displaced along as few directions as its site
+  // symmetry allows, all other columns are images under the point group
+  std::vector<int> representative(nAtoms, -1);
+  std::vector<int> mapping(nAtoms, -1);
+  Utils::HessianMatrix hessian = Utils::HessianMatrix::Zero(dimension, dimension);
+  for (int atom = 0; atom < nAtoms; ++atom) {
+    if (representative[atom] >= 0) {
+      continue;
+    }
+    for (unsigned k = 0; k < operations.size(); ++k) {
+      const int image = operations[k].permutation[atom];
+      if (representative[image] < 0) {
+        representative[image] = atom;
+        mapping[image] = k;
+      }
+    }
+    std::vector<Eigen::Vector3d> directions;
+    std::vector<Eigen::VectorXd> columns;
+    for (int d = 0; d < 3; ++d) {
+      Eigen::Vector3d direction = Eigen::Vector3d::Unit(d);
+      Eigen::MatrixXd known(3, directions.size());
+      for (unsigned m = 0; m < directions.size(); ++m) {
+        known.col(m) = directions[m];
+      }
+      if (!directions.empty()) {
+        Eigen::ColPivHouseholderQR<Eigen::MatrixXd> qr(known);
+        if ((known * qr.solve(direction) - direction).norm() < 1e-6) {
+          continue;
+        }
+      }
+      const Eigen::VectorXd c = column(atom, direction);
+      for (const auto& operation : operations) {
+        if (operation.permutation[atom] == atom) {
+          directions.push_back(operation.matrix * direction);
+          columns.push_back(operation.apply(c));
+        }
+      }
+    }
+    // Least squares solution of H_atom * directions = columns
+    Eigen::MatrixXd directionMatrix(3, directions.size());
+    Eigen::MatrixXd columnMatrix(dimension, columns.size());
+    for (unsigned m = 0; m < directions.size(); ++m) {
+      directionMatrix.col(m) = directions[m];
+      columnMatrix.col(m) = columns[m];
+    }
+    const Eigen::MatrixXd block =
+        columnMatrix * directionMatrix.transpose() * (directionMatrix * directionMatrix.transpose()).inverse();
+    // Images of the block for all equivalent atoms
+    for (int other = 0; other < nAtoms; ++other) {
+      if (representative[other] != atom) {
+        continue;
+      }
+      const auto& operation = operations[mapping[other]];
+      Eigen::MatrixXd image(dimension, 3);
+      for (int d = 0; d < 3; ++d) {
+        image.col(d) = operation.apply(block.col(d));
+      }
+      hessian.middleCols(3 * other, 3) = image * operation.matrix.transpose();
+    }
+  }
+  // Leave the session at the reference structure
+  session.updatePositions(reference);
+  session.singlepoint();
+  return 0.5 * (hessian + hessian.transpose());
+}
+
+Utils::HessianMatrix XtbCalculatorBase::_provideHessian(XtbSession& session) {
+  const std::string update = _settings.getString(XtbSettingsNames::hessianUpdate);
+  const Utils::PositionCollection& positions = _structure->getPositions();
+  const Utils::GradientCollection gradients = session.getGradients();
+  // A Hessian of other settings, e.g. another charge, solvent or temperature, is recalculated
+  const bool updatable = update != "none" && _lastHessian.size() > 0 &&
+                         _lastHessianGeneration == _settingsGeneration &&
+                         _lastHessianElements == _structure->getElements() &&
+                         _hessianUpdates < _settings.getInt(XtbSettingsNames::hessianUpdateMaxSteps);
+  if (updatable) {
+    const int dimension = 3 * positions.rows();
+    // Position and gradient collections are row-major, i.e. ordered as the Hessian
+    const Eigen::VectorXd s = Eigen::Map<const Eigen::VectorXd>(positions.data(), dimension) -
+                              Eigen::Map<const Eigen::VectorXd>(_lastHessianPositions.data(), dimension);
+    const Eigen::VectorXd y = Eigen::Map<const Eigen::VectorXd>(gradients.data(), dimension) -
+                              Eigen::Map<const Eigen::VectorXd>(_lastHessianGradients.data(), dimension);
+    if (s.norm() < 1e-10) {
+      _calculationInfo.hessianUpdates = _hessianUpdates;
+      return _lastHessian;
+    }
+    // Quality criterion: the prediction of the change of the gradients by the last Hessian
+    const Eigen::VectorXd xi = y - _lastHessian * s;
+    const bool accurate = xi.norm() <= _settings.getDouble(XtbSettingsNames::hessianUpdateThreshold) * y.norm();
+    Utils::HessianMatrix hessian = _lastHessian;
+    bool updated = accurate;
+    if (accurate && update == "bfgs") {
+      const Eigen::VectorXd hs = _lastHessian * s;
+      const double ys = y.dot(s);
+      const double shs = s.dot(hs);
+      // The curvature condition keeps the Hessian positive definite
+      updated = ys > 1e-10 && shs > 1e-10;
+      if (updated) {
+        hessian += y * y.transpose() / ys - hs * hs.transpose() / shs;
+      }
+    }
+    else if (accurate) {
+      const double ss = s.squaredNorm();
+      const double xis = xi.dot(s);
+      const Eigen::MatrixXd powell =
+          (xi * s.transpose() + s * xi.transpose()) / ss - xis / (ss * ss) * s * s.transpose();
+      if (update == "powell") {
+        hessian += powell;
+      }
+      else {
+        // Bofill: mixture of the symmetric rank-one and the Powell update
+        const double xixi = xi.squaredNorm();
+        const double phi = (xixi > 0.0 && std::abs(xis) > 1e-12) ? xis * xis / (xixi * ss) : 0.0;
+        hessian += (1.0 - phi) * powell;
+        if (phi > 0.0) {
+          hessian += phi * xi * xi.transpose() / xis;
+        }
+      }
+    }
+    if (updated) {
+      _lastHessian = hessian;
+      _lastHessianPositions = positions;
+      _lastHessianGradients = gradients;
+      _calculationInfo.hessianUpdates = ++_hessianUpdates;
+      return hessian;
+    }
+  }
+  _lastHessian = _calculateHessian(session);
+  _lastHessianElements = _structure->getElements();
+  _lastHessianPositions = positions;
+  _lastHessianGradients = gradients;
+  _lastHessianGeneration = _settingsGeneration;
+  _hessianUpdates = 0;
+  _calculationInfo.hessianUpdates = 0;
+  return _lastHessian;
+}
+
+double XtbCalculatorBase::_homoLumoGap(const Eigen::VectorXd& orbitalEnergies) const {
+  // Highest (singly) occupied orbital of the aufbau occupation
+  const int uhf = _settings.getInt(Utils::SettingsNames::spinMultiplicity) - 1;
+  const int homo = (_numberOfElectrons() + uhf) / 2 - 1;
+  if (homo < 0 || homo + 1 >= orbitalEnergies.size()) {
+    return 0.0;
+  }
+  return orbitalEnergies(homo + 1) - orbitalEnergies(homo);
+}
+
+std::uint64_t XtbCalculatorBase::_fingerprint() const {
+  // FNV-1a
+  std::uint64_t hash = 14695981039346656037ull;
+  auto add = [&hash](const void* data, std::size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+      hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+  };
+  auto addString = [&add](const std::string& value) { add(value.data(), value.size() + 1); };
+  addString(name());
+  for (const auto& element : _structure->getElements()) {
+    const int z = Utils::ElementInfo::Z(element);
+    add(&z, sizeof(z));
+  }
+  const auto& positions = _structure->getPositions();
+  add(positions.data(), positions.size() * sizeof(double));
+  for (const auto& key : {Utils::SettingsNames::molecularCharge, Utils::SettingsNames::spinMultiplicity,
+                          Utils::SettingsNames::maxScfIterations, XtbSettingsNames::solvationGridPoints}) {
+    const int value = _settings.getInt(key);
+    add(&value, sizeof(value));
+  }
+  for (const auto& key :
+       {Utils::SettingsNames::selfConsistenceCriterion, Utils::SettingsNames::electronicTemperature}) {
+    const double value = _settings.getDouble(key);
+    add(&value, sizeof(value));
+  }
+  for (const auto& key : {Utils::SettingsNames::solvent, Utils::SettingsNames::solvation,
+                          Utils::SettingsNames::periodicBoundaries}) {
+    addString(_settings.getString(key));
+  }
+  const auto mmCharges = _settings.getDoubleList(Utils::SettingsNames::mmCharges);
+  add(mmCharges.data(), mmCharges.size() * sizeof(double));
+  return hash;
+}
+
+std::string XtbCalculatorBase::_restartPath() const {
+  const std::string directory = _settings.getString(XtbSettingsNames::restartDirectory);
+  if (directory.empty()) {
+    return "";
+  }
+  std::ostringstream path;
+  path << directory << "/" << std::hex << std::setw(16) << std::setfill('0') << _fingerprint() << ".xtbrestart";
+  return path.str();
+}
+
+bool XtbCalculatorBase::_readRestart() {
+  const std::string path = _restartPath();
+  XtbRestartFile restart;
+  if (path.empty() || !restart.read(path) || restart.fingerprint != _fingerprint() ||
+      restart.nAtoms != _structure->size()) {
+    return false;
+  }
+  // Only the properties of the single point itself can be restored
+  Utils::PropertyList restorable =
+      Utils::Property::Energy | Utils::Property::SuccessfulCalculation | Utils::Property::ProgramName;
+  if (restart.gradients.size() > 0) {
+    restorable.addProperty(Utils::Property::Gradients);
+  }
+  if (!restart.atomicCharges.empty()) {
+    restorable.addProperty(Utils::Property::AtomicCharges);
+  }
+  if (restart.dipole.size() == 3) {
+    restorable.addProperty(Utils::Property::Dipole);
+  }
+  if (restart.orbitalEnergies.size() > 0) {
+    restorable.addProperty(Utils::Property::OrbitalEnergies);
+  }
+  if (!restorable.containsSubSet(_calculatedProperties)) {
+    return false;
+  }
+  this->_results = Scine::Utils::Results();
+  this->_results.set<Scine::Utils::Property::Energy>(restart.energy);
+  if (_calculatedProperties.containsSubSet(Scine::Utils::Property::Gradients)) {
+    this->_results.set<Scine::Utils::Property::Gradients>(restart.gradients);
+  }
+  if (_calculatedProperties.containsSubSet(Scine::Utils::Property::AtomicCharges)) {
+    this->_results.set<Scine::Utils::Property::AtomicCharges>(restart.atomicCharges);
+  }
+  if (_calculatedProperties.containsSubSet(Scine::Utils::Property::Dipole)) {
+    this->_results.set<Scine::Utils::Property::Dipole>(restart.dipole);
+  }
+  if (_calculatedProperties.containsSubSet(Scine::Utils::Property::OrbitalEnergies)) {
+    auto orbitalEnergies = Utils::SingleParticleEnergies::createEmptyRestrictedEnergies();
+    orbitalEnergies.setRestricted(restart.orbitalEnergies);
+    this->_results.set<Scine::Utils::Property::OrbitalEnergies>(std::move(orbitalEnergies));
+  }
+  _calculationInfo.orbitalOccupations = restart.orbitalOccupations;
+  _calculationInfo.homoLumoGap = _homoLumoGap(restart.orbitalEnergies);
+  this->_results.set<Scine::Utils::Property::SuccessfulCalculation>(true);
+  _settings.modifyString(Utils::SettingsNames::spinMode,
+                         Utils::SpinModeInterpreter::getStringFromSpinMode(Utils::SpinMode::RestrictedOpenShell));
+  this->_results.set<Scine::Utils::Property::ProgramName>("Xtb");
+  return true;
+}
+
+void XtbCalculatorBase::_writeRestart(XtbSession& session) {
+  const std::string path = _restartPath();
+  if (path.empty()) {
+    return;
+  }
+  XtbRestartFile restart;
+  restart.fingerprint = _fingerprint();
+  restart.nAtoms = _structure->size();
+  restart.energy = _results.get<Utils::Property::Energy>();
+  if (_results.has<Utils::Property::Gradients>()) {
+    restart.gradients = _results.get<Utils::Property::Gradients>();
+  }
+  if (possibleProperties().containsSubSet(Utils::Property::AtomicCharges)) {
+    restart.atomicCharges.resize(restart.nAtoms);
+    session.getCharges(restart.atomicCharges.data());
+  }
+  if (_results.has<Utils::Property::Dipole>()) {
+    restart.dipole = _results.get<Utils::Property::Dipole>();
+  }
+  if (possibleProperties().containsSubSet(Utils::Property::OrbitalEnergies)) {
+    restart.orbitalEnergies = session.getOrbitalEnergies();
+    restart.orbitalOccupations = _calculationInfo.orbitalOccupations;
+  }
+  try {
+    restart.write(path);
+  }
+  catch (const std::runtime_error& /* e */) {
+    // A missing restart file only costs a new calculation, this one succeeded
+  }
+}
+
+const Scine::Utils::Results& XtbCalculatorBase::calculate(std::string /* dummy */) {
+  _startClock();
+  // A cached result needs neither the parametrization nor the setup of xtb
+  _validate();
+  _applyMemoryLimit();
+  if (_readRestart()) {
+    return this->_results;
+  }
+  // The session releases all xtb handles if the calculation is cancelled
+  auto session = createSession();
+  try {
+    checkCancellation();
+    _singlepoint(*session);
+    checkCancellation();
+    _parseResults(*session);
+  }
+  catch (...) {
+    _collectOutput(*session, true);
+    throw;
+  }
+  _collectOutput(*session, false);
+  _writeRestart(*session);
+  return this->_results;
+}
+
+std::future<Scine::Utils::Results> XtbCalculatorBase::calculateAsync(XtbExecutor& executor,
+                                                                     XtbExecutor::Callback callback) const {
+  return executor.submit(clone(), std::move(callback));
+}
+
+std::vector<Scine::Utils::Results>
+XtbCalculatorBase::calculateSolvents(const std::vector<std::string>& solvents) const {
+  if (!_structure) {
+    throw std::runtime_error("The " + name() + " calculator does currently not hold a structure");
+  }
+  const auto availableSolvents = this->availableSolvents();
+  std::vector<std::string> names;
+  for (auto solvent : solvents) {
+    std::for_each(solvent.begin(), solvent.end(), [](char& c) { c = ::tolower(c); });
+    if (solvent == "none") {
+      solvent.clear();
+    }
+    if (!solvent.empty() &&
+        std::find(availableSolvents.begin(), availableSolvents.end(), solvent) == availableSolvents.end()) {
+      throw std::runtime_error("The solvent '" + solvent + "' is not available for implicit solvation within " +
+                               method() + ".");
+    }
+    names.push_back(solvent);
+  }
+  const int nSolvents = names.size();
+  const int nThreads = std::max(1, std::min(_settings.getInt(Utils::SettingsNames::externalProgramNProcs), nSolvents));
+  // The configured solvation model, gbsa if the calculator is set up for the gas phase
+  std::string model = _settings.getString(Utils::SettingsNames::solvation);
+  std::for_each(model.begin(), model.end(), [](char& c) { c = ::tolower(c); });
+  if (model.empty() || model == "none") {
+    model = "gbsa";
+  }
+  // The gas phase is calculated once, for its first occurrence
+  const auto gasPhase = std::find(names.begin(), names.end(), "");
+  const int gasPhaseIndex = gasPhase == names.end() ? -1 : static_cast<int>(gasPhase - names.begin());
+  std::vector<Utils::Results> results(nSolvents);
+  std::exception_ptr error = nullptr;
+#pragma omp parallel num_threads(nThreads)
+  {
+    std::shared_ptr<XtbCalculatorBase> calculator;
+    std::unique_ptr<XtbSession> session;
+#pragma omp for schedule(static)
+    for (int n = 0; n < nSolvents; ++n) {
+      if (names[n].empty() && n != gasPhaseIndex) {
+        continue;
+      }
+      try {
+        if (!calculator) {
+          calculator = clone();
+          calculator->settings().modifyInt(Utils::SettingsNames::externalProgramNProcs, 1);
+        }
+        // Only the solvation model of the session is replaced, the SCF starts from the previous wavefunction
+        auto& settings = calculator->settings();
+        settings.modifyString(Utils::SettingsNames::solvent, names[n]);
+        settings.modifyString(Utils::SettingsNames::solvation, names[n].empty() ? "" : model);
+        if (!session) {
+          session = calculator->createSession();
+        }
+        results[n] = calculator->calculate(*session);
+      }
+      catch (...) {
+#pragma omp critical(XtbSolventScanError)
+        {
+          if (!error) {
+            error = std::current_exception();
+          }
+        }
+      }
+    }
+  }
+  for (int n = 0; n < nSolvents; ++n) {
+    if (names[n].empty() && n != gasPhaseIndex) {
+      results[n] = results[gasPhaseIndex];
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return results;
+}
+
+const Scine::Utils::Results& XtbCalculatorBase::calculate(XtbSession& session) {
+  _runSinglepoint(session, [&]() { _parseResults(session); });
+  return this->_results;
+}
+
+void XtbCalculatorBase::calculate(XtbSession& session, const XtbOutputBuffers& buffers) {
+  _runSinglepoint(session, [&]() {
+    if (buffers.energy) {
+      *buffers.energy = session.getEnergy();
+    }
+    if (buffers.gradients) {
+      session.getGradients(buffers.gradients);
+    }
+    if (buffers.atomicCharges) {
+      if (!possibleProperties().containsSubSet(Utils::Property::AtomicCharges)) {
+        throw std::logic_error("The " + name() + " calculator does not provide atomic charges.");
+      }
+      session.getCharges(buffers.atomicCharges);
+    }
+  });
+}
+
+Scine::Utils::Results XtbCalculatorBase::takeResults() {
+  Utils::Results results = std::move(_results);
+  _results = Utils::Results();
+  return results;
+}
+
+void XtbCalculatorBase::_runSinglepoint(XtbSession& session, const std::function<void()>& extract) {
+  if (!_structure || _structure->getElements() != session.getElements()) {
+    throw std::runtime_error("The xtb session does not match the elements of the " + name() + " calculator.");
+  }
+  _validate();
+  if (session.getSettingsGeneration() != _settingsGeneration) {
+    // Only the settings of the xtb calculator can be changed within a session
+    if (session.getCharge() != _settings.getInt(Utils::SettingsNames::molecularCharge) ||
+        session.getUnpairedElectrons() != _settings.getInt(Utils::SettingsNames::spinMultiplicity) - 1) {
+      throw std::runtime_error("The charge or multiplicity of the " + name() +
+                               " calculator changed, which requires a new xtb session.");
+    }
+    _applySettings(session);
+    _setExternalCharges(session);
+    _setSolvation(session);
+    session.setSettingsGeneration(_settingsGeneration);
+  }
+  _applyMemoryLimit();
+  _startClock();
+  session.clearOutput();
+  try {
+    checkCancellation();
+    session.updatePositions(_structure->getPositions());
+    _singlepoint(session);
+    checkCancellation();
+    extract();
+  }
+  catch (...) {
+    _collectOutput(session, true);
+    throw;
+  }
+  _collectOutput(session, false);
+}
+
+void XtbCalculatorBase::_singlepoint(XtbSession& session) {
+  if (!_settings.getBool(XtbSettingsNames::scfRecovery)) {
+    session.singlepoint();
+    return;
+  }
+  const double temperature = _settings.getDouble(Utils::SettingsNames::electronicTemperature);
+  const int maxIterations = _settings.getInt(Utils::SettingsNames::maxScfIterations);
+  const double hot = _settings.getDouble(XtbSettingsNames::scfRecoveryTemperature);
+  const int factor = _settings.getInt(XtbSettingsNames::scfRecoveryIterationFactor);
+  // The attempts, the one at the raised temperature only prepares the wavefunction
+  std::vector<std::pair<double, int>> ladder = {{temperature, maxIterations}};
+  if (hot > temperature) {
+    ladder.emplace_back(hot, maxIterations);
+    ladder.emplace_back(temperature, maxIterations);
+  }
+  if (factor > 1) {
+    ladder.emplace_back(temperature, factor * maxIterations);
+  }
+  // The session outlives this calculation, so the regular values are restored in any case
+  try {
+    for (unsigned k = 0; k < ladder.size(); ++k) {
+      checkCancellation();
+      ScfAttempt attempt;
+      attempt.electronicTemperature = ladder[k].first;
+      attempt.maxIterations = ladder[k].second;
+      session.setElectronicTemperature(attempt.electronicTemperature);
+      session.setMaxIterations(attempt.maxIterations);
+      try {
+        session.singlepoint();
+        attempt.converged = true;
+      }
+      catch (const Core::UnsuccessfulCalculationException& e) {
+        attempt.message = e.what();
+      }
+      _calculationInfo.scfAttempts.push_back(attempt);
+      if (attempt.converged && attempt.electronicTemperature == temperature) {
+        break;
+      }
+    }
+  }
+  catch (...) {
+    session.setElectronicTemperature(temperature);
+    session.setMaxIterations(maxIterations);
+    throw;
+  }
+  session.setElectronicTemperature(temperature);
+  session.setMaxIterations(maxIterations);
+  const auto& last = _calculationInfo.scfAttempts.back();
+  if (!last.converged || last.electronicTemperature != temperature) {
+    throw Core::UnsuccessfulCalculationException("XTB: The SCF did not converge in " +
+                                                 std::to_string(_calculationInfo.scfAttempts.size()) +
+                                                 " attempts of the convergence recovery:\n" + last.message);
+  }
+}
+
+void XtbCalculatorBase::_collectOutput(XtbSession& session, bool failed) {
+  if (!session.isCapturingOutput()) {
+    return;
+  }
+  _calculationInfo.output = session.getOutput();
+  session.clearOutput();
+  if (_outputSink) {
+    _outputSink(_calculationInfo.output, failed);
+  }
+}
+
+std::unique_ptr<XtbSession> XtbCalculatorBase::createSession() {
+  _validate();
+  _applyMemoryLimit();
+#if defined(_OPENMP)
+  const int nCores = _settings.getInt(Utils::SettingsNames::externalProgramNProcs);
+  omp_set_dynamic(0); // Explicitly disable dynamic teams
+  omp_set_num_threads(nCores);
+#endif
+  const double charge = _settings.getInt(Utils::SettingsNames::molecularCharge); // double because xtb wants double
+  const int uhf = _settings.getInt(Utils::SettingsNames::spinMultiplicity) - 1;
+  std::unique_ptr<XtbSession> session;
+  const std::string periodicBoundaries = _settings.getString(Utils::SettingsNames::periodicBoundaries);
+  if (periodicBoundaries.empty()) {
+    session = std::make_unique<XtbSession>(*_structure, charge, uhf);
+  }
+  else {
+    if (!supportsPeriodicBoundaries()) {
+      throw std::logic_error("The " + name() + " calculator does not support periodic boundary conditions.");
+    }
+    const Utils::PeriodicBoundaries pbc(periodicBoundaries);
+    session = std::make_unique<XtbSession>(*_structure, charge, uhf, pbc.getCellMatrix(), pbc.getPeriodicity());
+  }
+  if (_settings.getString(XtbSettingsNames::outputMode) == "capture") {
+    session->captureOutput(static_cast<std::size_t>(_settings.getInt(XtbSettingsNames::outputBufferSize)) * 1024);
+  }
+
+  // Setup XTB model
+  checkCancellation();
+  _loadMethod(*session);
+  session->checkEnvironment("XTB method setup failed.");
+  checkCancellation();
+
+  _applySettings(*session);
+  _setExternalCharges(*session);
+  _setSolvation(*session);
+  session->setSettingsGeneration(_settingsGeneration);
+  return session;
+}
+
+void XtbCalculatorBase::_validate() {
+  if (_settingsGeneration != 0 && _structure && _structure->getElements() == _validatedElements &&
+      _settings.getValueCollection() == _validatedSettings) {
+    return;
+  }
+  if (!_settings.valid()) {
+    _settings.throwIncorrectSettings();
+  }
+  verifyPesValidity();
+  _validatedElements = _structure->getElements();
+  _validatedSettings = _settings.getValueCollection();
+  // Unique across all calculators, such that a session tells which settings it holds
+  static std::atomic<std::uint64_t> generations{0};
+  _settingsGeneration = ++generations;
+}
+
+void XtbCalculatorBase::_applySettings(XtbSession& session) {
+  session.setSelfConsistenceCriterion(_settings.getDouble(Utils::SettingsNames::selfConsistenceCriterion));
+  session.setMaxIterations(_settings.getInt(Utils::SettingsNames::maxScfIterations));
+  session.setElectronicTemperature(_settings.getDouble(Utils::SettingsNames::electronicTemperature));
+  session.setVerbosity(_settings.getInt("print_level"));
+}
+
+void XtbCalculatorBase::_setExternalCharges(XtbSession& session) {
+  if (!possibleProperties().containsSubSet(Utils::Property::PointChargesGradients)) {
+    return;
+  }
   std::vector<double> chargesAndPositions = _settings.getDoubleList(Utils::SettingsNames::mmCharges);
   if (chargesAndPositions.empty()) {
+    session.clearExternalCharges();
     return;
   }
   const auto nCharges = chargesAndPositions.size();
   if (nCharges % 5 != 0) {
-    _cleanDataStructures(env, calc, res, mol);
     throw std::runtime_error("The number of external charges and positions is not a multiple of 5.");
   }
   std::vector<double> charges;
@@ -167,7 +966,6 @@ void XtbCalculatorBase::setExternalCharges(xtb_TEnvironment& env, xtb_TCalculato
     charges.push_back(chargesAndPositions[i]);
     const auto atomicNumber = chargesAndPositions[i + 1];
     if (atomicNumber < 1 || atomicNumber > 118) {
-      _cleanDataStructures(env, calc, res, mol);
       throw std::runtime_error("The atomic number of an external charge is not in the range [1, 118].");
     }
     atomicNumbers.push_back(static_cast<int>(atomicNumber));
@@ -176,20 +974,158 @@ void XtbCalculatorBase::setExternalCharges(xtb_TEnvironment& env, xtb_TCalculato
     positions.row(j).z() = chargesAndPositions[i + 4];
     j++;
   }
-  auto nEntries = static_cast<int>(nCharges / 5);
-  xtb_setExternalCharges(env, calc, &nEntries, atomicNumbers.data(), charges.data(), positions.data());
-  _setExternalCharges = true;
+  session.setExternalCharges(std::move(atomicNumbers), std::move(charges), std::move(positions));
 }
 
-void XtbCalculatorBase::_cleanDataStructures(xtb_TEnvironment& env, xtb_TCalculator& calc, xtb_TResults& res,
-                                             xtb_TMolecule& mol) {
-  if (_setExternalCharges) {
-    xtb_releaseExternalCharges(env, calc);
+void XtbCalculatorBase::_setSolvation(XtbSession& session) {
+  const auto availableSolvents = this->availableSolvents();
+  if (availableSolvents.empty()) {
+    std::string solvent = _settings.getString(Utils::SettingsNames::solvent);
+    std::string solvation = _settings.getString(Utils::SettingsNames::solvation);
+    std::for_each(solvent.begin(), solvent.end(), [](char& c) { c = ::tolower(c); });
+    std::for_each(solvation.begin(), solvation.end(), [](char& c) { c = ::tolower(c); });
+    if ((!solvent.empty() && solvent != "none") || (!solvation.empty() && solvation != "none")) {
+      throw std::logic_error("The " + method() + " Hamiltonian is not parametrized for implicit solvation.");
+    }
+    return;
+  }
+  if (Utils::Solvation::ImplicitSolvation::solvationNeededAndPossible(_availableSolvationModels, _settings)) {
+    if (session.isPeriodic()) {
+      throw std::logic_error("Implicit solvation is not available with periodic boundary conditions.");
+    }
+    std::string solvent = _settings.getString(Utils::SettingsNames::solvent);
+    std::for_each(solvent.begin(), solvent.end(), [](char& c) { c = ::tolower(c); });
+    if (std::find(availableSolvents.begin(), availableSolvents.end(), solvent) == availableSolvents.end()) {
+      throw std::runtime_error("The given solvent is not available for implicit solvation within " + method() + ".");
+    }
+    // The Lebedev grids available in xtb
+    static const std::vector<int> lebedevGrids = {6,    14,   26,   38,   50,   74,   86,   110,  146,  170,  194,
+                                                  230,  266,  302,  350,  434,  590,  770,  974,  1202, 1454, 1730,
+                                                  2030, 2354, 2702, 3074, 3470, 3890, 4334, 4802, 5294, 5810};
+    const int gridPoints = _settings.getInt(XtbSettingsNames::solvationGridPoints);
+    if (!std::binary_search(lebedevGrids.begin(), lebedevGrids.end(), gridPoints)) {
+      throw std::runtime_error("XTB: " + std::to_string(gridPoints) + " is not the size of a Lebedev grid.");
+    }
+    session.setSolvent(solvent, _settings.getDouble(Utils::SettingsNames::temperature), gridPoints);
+  }
+  else {
+    session.setSolvent("", 0.0, 0);
+  }
+}
+
+void XtbCalculatorBase::_parseResults(XtbSession& session) {
+  auto& env = session.environment();
+  auto& res = session.results();
+  const int natoms = session.size();
+  this->_results = Scine::Utils::Results();
+  // - Energy
+  this->_results.set<Scine::Utils::Property::Energy>(session.getEnergy());
+  // - Gradients
+  if (_calculatedProperties.containsSubSet(Scine::Utils::Property::Gradients)) {
+    this->_results.set<Scine::Utils::Property::Gradients>(session.getGradients());
+  }
+  // - Bond orders
+  if (_calculatedProperties.containsSubSet(Scine::Utils::Property::BondOrderMatrix)) {
+    Eigen::MatrixXd wbo = Eigen::MatrixXd::Zero(natoms, natoms);
+    xtb_getBondOrders(env, res, wbo.data());
+    session.checkEnvironment("Could not read XTB bond orders.");
+    Scine::Utils::BondOrderCollection bos(natoms);
+    bos.setMatrix(wbo.sparseView(1e-12, 1.0));
+    this->_results.set<Scine::Utils::Property::BondOrderMatrix>(bos);
+  }
+  // - Point Charge Gradients
+  if (_calculatedProperties.containsSubSet(Scine::Utils::Property::PointChargesGradients)) {
+    std::vector<double> chargesAndPositions = _settings.getDoubleList(Utils::SettingsNames::mmCharges);
+    if (chargesAndPositions.empty()) {
+      throw std::runtime_error("Cannot give point charges gradients, because no point charges were given.");
+    }
+    const auto nCharges = chargesAndPositions.size() / 5;
+    Utils::GradientCollection grad = Utils::GradientCollection::Zero(nCharges, 3);
+    xtb_getPCGradient(env, res, grad.data());
+    session.checkEnvironment("Could not read XTB point charges gradients.");
+    this->_results.set<Scine::Utils::Property::PointChargesGradients>(grad);
+  }
+  // - Partial charges
+  if (_calculatedProperties.containsSubSet(Scine::Utils::Property::AtomicCharges)) {
+    std::vector<double> q(natoms, 0.0);
+    session.getCharges(q.data());
+    this->_results.set<Scine::Utils::Property::AtomicCharges>(std::move(q));
+  }
+  // - Dipole
+  if (_calculatedProperties.containsSubSet(Scine::Utils::Property::Dipole)) {
+    this->_results.set<Scine::Utils::Property::Dipole>(session.getDipole());
+  }
+  // - Orbitals, the occupations and the gap are always reported as they come at no cost
+  if (possibleProperties().containsSubSet(Scine::Utils::Property::OrbitalEnergies)) {
+    const Eigen::VectorXd energies = session.getOrbitalEnergies();
+    if (_calculatedProperties.containsSubSet(Scine::Utils::Property::OrbitalEnergies)) {
+      auto orbitalEnergies = Utils::SingleParticleEnergies::createEmptyRestrictedEnergies();
+      orbitalEnergies.setRestricted(energies);
+      this->_results.set<Scine::Utils::Property::OrbitalEnergies>(std::move(orbitalEnergies));
+    }
+    _calculationInfo.orbitalOccupations = session.getOrbitalOccupations();
+    _calculationInfo.homoLumoGap = _homoLumoGap(energies);
+  }
+  // - Stress tensor
+  if (_calculatedProperties.containsSubSet(Scine::Utils::Property::StressTensor)) {
+    if (!session.isPeriodic()) {
+      throw std::runtime_error("Cannot give the stress tensor, because no periodic boundaries were given.");
+    }
+    const Utils::PeriodicBoundaries pbc(_settings.getString(Utils::SettingsNames::periodicBoundaries));
+    const double volume = std::abs(pbc.getCellMatrix().determinant());
+    this->_results.set<Scine::Utils::Property::StressTensor>(session.getVirial() / volume);
+  }
+  // - Occupation
+  if (_calculatedProperties.containsSubSet(Scine::Utils::Property::ElectronicOccupation) or
+      _calculatedProperties.containsSubSet(Scine::Utils::Property::Hessian) or
+      _calculatedProperties.containsSubSet(Scine::Utils::Property::Thermochemistry)) {
+    const int nElectrons = _numberOfElectrons();
+    const int uhf = _settings.getInt(Utils::SettingsNames::spinMultiplicity) - 1;
+    auto occupation = Scine::Utils::LcaoUtils::ElectronicOccupation();
+    if (uhf == 0) {
+      occupation.fillLowestRestrictedOrbitalsWithElectrons(nElectrons);
+    }
+    else {
+      int alpha = (nElectrons + uhf) / 2;
+      int beta = (nElectrons - uhf) / 2;
+      occupation.fillLowestUnrestrictedOrbitals(alpha, beta);
+    }
+    this->_results.set<Scine::Utils::Property::ElectronicOccupation>(occupation);
+  }
+  // - Hessian
+  if (_calculatedProperties.containsSubSet(Scine::Utils::Property::Hessian) or
+      _calculatedProperties.containsSubSet(Scine::Utils::Property::Thermochemistry)) {
+    this->_results.set<Utils::Property::Hessian>(_provideHessian(session));
+  }
+
+  // set successful to be able to autocomplete thermochemistry
+  this->_results.set<Scine::Utils::Property::SuccessfulCalculation>(true);
+  _settings.modifyString(Utils::SettingsNames::spinMode,
+                         Utils::SpinModeInterpreter::getStringFromSpinMode(Utils::SpinMode::RestrictedOpenShell));
+  this->_results.set<Scine::Utils::Property::ProgramName>("Xtb");
+
+  // - Thermochemistry
+  if (_calculatedProperties.containsSubSet(Scine::Utils::Property::Hessian) or
+      _calculatedProperties.containsSubSet(Scine::Utils::Property::Thermochemistry)) {
+    Scine::Utils::ResultsAutoCompleter completer(*_structure);
+    completer.setTemperature(_settings.getDouble(Utils::SettingsNames::temperature));
+    completer.setPressure(_settings.getDouble(Utils::SettingsNames::pressure));
+    completer.setMolecularSymmetryNumber(_settings.getInt(Utils::SettingsNames::symmetryNumber));
+    completer.addOneWantedProperty(Scine::Utils::Property::Thermochemistry);
+    completer.generateProperties(this->_results, *_structure);
+  }
+
+  // - Memory
+#if defined(__unix__) || defined(__APPLE__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#  if defined(__APPLE__)
+    _calculationInfo.peakResidentMemory = static_cast<std::size_t>(usage.ru_maxrss);
+#  else
+    _calculationInfo.peakResidentMemory = static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+#  endif
   }
-  xtb_delResults(&res);
-  xtb_delCalculator(&calc);
-  xtb_delMolecule(&mol);
-  xtb_delEnvironment(&env);
+#endif
 }
 
 } /* namespace Xtb */
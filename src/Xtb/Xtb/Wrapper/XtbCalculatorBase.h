@@ -8,6 +8,11 @@
 #define XTB_XTBCALCULATORBASE_H_
 
 /* Internal Includes */
+#include "Xtb/Wrapper/CancellationToken.h"
+#include "Xtb/Wrapper/XtbCalculationInfo.h"
+#include "Xtb/Wrapper/XtbExecutor.h"
+#include "Xtb/Wrapper/XtbOutputBuffers.h"
+#include "Xtb/Wrapper/XtbSession.h"
 #include "Xtb/Wrapper/XtbSettings.h"
 
 /* External Includes */
@@ -19,6 +24,9 @@
 #include <Utils/Technical/CloneInterface.h>
 #include <Utils/UniversalSettings/SettingsNames.h>
 #include <xtb.h>
+#include <chrono>
+#include <cstdint>
+#include <functional>
 
 namespace Scine {
 
@@ -38,6 +46,11 @@ class XtbCalculatorBase
  public:
   /// @brief Default Constructor
   XtbCalculatorBase() = default;
+  /**
+   * @brief Constructs the calculator of a method.
+   * @param method One of GFN0, GFN1, GFN2 and GFN-FF.
+   */
+  static std::shared_ptr<XtbCalculatorBase> create(const std::string& method);
   /// @brief Default Destructor.
   ~XtbCalculatorBase() override = default;
   /// @brief Copy Constructor.
@@ -93,12 +106,134 @@ class XtbCalculatorBase
    * can produce.
    */
   virtual Scine::Utils::PropertyList possibleProperties() const = 0;
+  /**
+   * @brief Returns the implicit solvents the method is parametrized for.
+   * @return std::vector<std::string> The lower case solvent names, empty if the
+   *         method does not support implicit solvation.
+   */
+  virtual std::vector<std::string> availableSolvents() const = 0;
+  /**
+   * @brief Whether the method can be applied with periodic boundary conditions.
+   */
+  virtual bool supportsPeriodicBoundaries() const = 0;
   /**
    * @brief The main function running calculations.
    * @param dummy   A dummy parameter.
    * @return Scine::Utils::Results Return the result of the calculation.
    */
-  virtual const Scine::Utils::Results& calculate(std::string dummy) = 0;
+  const Scine::Utils::Results& calculate(std::string dummy) final;
+  /**
+   * @brief Runs a calculation asynchronously on the given executor.
+   *
+   * The calculation is run on a clone of this calculator, such that this
+   * calculator can be modified and reused right after the submission. The call
+   * blocks while the queue of the executor is full.
+   *
+   * @param executor The executor running the calculation.
+   * @param callback The optional completion callback.
+   * @return std::future<Scine::Utils::Results> The results of the calculation.
+   */
+  std::future<Scine::Utils::Results> calculateAsync(XtbExecutor& executor,
+                                                    XtbExecutor::Callback callback = nullptr) const;
+  /**
+   * @brief Calculates the current structure in each of the given solvents.
+   *
+   * The solvents are distributed in contiguous blocks over up to
+   * externalProgramNProcs threads, each of which sets up one session
+   * (molecule and parametrization) for its block. The SCF of each solvent
+   * starts from the wavefunction of the previous calculation of the session.
+   * The configured solvation model is used, gbsa if there is none. The gas
+   * phase is only calculated if requested, and only once.
+   *
+   * @param solvents The solvents, 'none' or an empty string for the gas phase.
+   * @return std::vector<Scine::Utils::Results> The results, in the order of the solvents.
+   * @throws std::runtime_error if a solvent is not available for the method.
+   */
+  std::vector<Scine::Utils::Results> calculateSolvents(const std::vector<std::string>& solvents) const;
+  /**
+   * @brief Sets up a new xtb session for the current structure and settings.
+   *
+   * The returned session is fully prepared (parametrization, SCF settings,
+   * external charges and implicit solvation) and can be used for any number of
+   * single points on updated positions of the current structure.
+   *
+   * @return std::unique_ptr<XtbSession> The prepared session.
+   */
+  std::unique_ptr<XtbSession> createSession();
+  /**
+   * @brief Runs a calculation for the current positions within an existing session.
+   *
+   * The SCF is restarted from the wavefunction of the previous single point of
+   * the session.
+   *
+   * @param session A session created by createSession() for the current structure.
+   * @return Scine::Utils::Results Return the result of the calculation.
+   * @throws std::runtime_error If the elements of the session differ from the ones of the structure.
+   */
+  const Scine::Utils::Results& calculate(XtbSession& session);
+  /**
+   * @brief Runs a calculation for the current positions within an existing
+   *        session and writes the results into caller-owned buffers.
+   *
+   * Neither the results nor any intermediate copies are created, which makes
+   * this the cheapest way to drive many single points, e.g. in dynamics. The
+   * required properties are ignored and results() is not updated.
+   *
+   * @param session A session created by createSession() for the current structure.
+   * @param buffers The buffers of the requested quantities.
+   */
+  void calculate(XtbSession& session, const XtbOutputBuffers& buffers);
+  /**
+   * @brief Moves the results of the last calculation out of the calculator,
+   *        leaving empty results behind.
+   */
+  Scine::Utils::Results takeResults();
+  /**
+   * @brief Estimates the peak memory of a calculation.
+   *
+   * The estimate comprises the internal matrices of xtb, which are derived from
+   * the number of atomic orbitals of the structure, and the dense matrices of
+   * the requested properties (bond orders, Hessian). It is meant as an upper
+   * bound for scheduling and for the memory_limit setting.
+   *
+   * @param structure  The structure to be calculated.
+   * @param properties The properties to be calculated.
+   * @return std::size_t The estimated memory in bytes.
+   */
+  std::size_t estimateMemory(const Utils::AtomCollection& structure, const Utils::PropertyList& properties) const;
+  /**
+   * @brief Sets the token to cancel the calculations of this calculator and of its clones.
+   * @param token The token, nullptr to remove the current token.
+   */
+  void setCancellationToken(std::shared_ptr<CancellationToken> token);
+  /**
+   * @brief Receives the captured output of xtb after each calculation.
+   *
+   * The sink is shared with the clones of this calculator and must therefore be
+   * thread-safe if the clones are run concurrently.
+   */
+  using OutputSink = std::function<void(const std::string& output, bool failed)>;
+  /**
+   * @brief Sets the sink of the captured output (output_mode 'capture').
+   * @param sink The sink, nullptr to only keep the output in the calculation info.
+   */
+  void setOutputSink(OutputSink sink);
+  /// @brief Getter for the cancellation token, nullptr if none is set.
+  std::shared_ptr<CancellationToken> getCancellationToken() const;
+  /**
+   * @brief Throws if the calculation was cancelled or exceeded its time limit.
+   * @throws CalculationCancelledException
+   */
+  void checkCancellation() const;
+  /**
+   * @brief Getter for additional information on the last calculation, e.g. its memory usage.
+   */
+  const XtbCalculationInfo& calculationInfo() const;
+  /**
+   * @brief Discards the stored Hessian of the Hessian updates, such that the
+   *        next Hessian is calculated exactly.
+   */
+  void resetHessianUpdates();
   /**
    * @brief Accessor for the Settings used in this method wrapper.
    * @returns Scine::Utils::Settings& The Settings.
@@ -149,10 +284,142 @@ class XtbCalculatorBase
   Scine::Utils::Results _results;
   Scine::Utils::PropertyList _requiredProperties;
   std::unique_ptr<Scine::Utils::AtomCollection> _structure;
+  // The required properties that are calculated given the memory limit
+  Scine::Utils::PropertyList _calculatedProperties;
+  XtbCalculationInfo _calculationInfo;
+  std::shared_ptr<CancellationToken> _cancellationToken;
+  // The deadline of the current calculation, if a time limit is set
+  bool _hasDeadline = false;
+  std::chrono::steady_clock::time_point _deadline;
+  OutputSink _outputSink;
+  // The settings and elements of the last successful validation, and a generation
+  // number unique among all calculators identifying them, 0 if not yet validated
+  Utils::UniversalSettings::ValueCollection _validatedSettings;
+  Utils::ElementTypeCollection _validatedElements;
+  std::uint64_t _settingsGeneration = 0;
+  // The electron and orbital counts of the last validated elements
+  struct ElectronAndAoCounts {
+    Utils::ElementTypeCollection elements;
+    int valenceElectrons = 0;
+    int nAos = 0;
+    bool supported = true;
+  };
+  ElectronAndAoCounts _counts;
+  // The last Hessian and the point it refers to, for the hessian_update setting
+  Utils::HessianMatrix _lastHessian;
+  Utils::ElementTypeCollection _lastHessianElements;
+  Utils::PositionCollection _lastHessianPositions;
+  Utils::GradientCollection _lastHessianGradients;
+  // The settings generation the last Hessian was calculated with
+  std::uint64_t _lastHessianGeneration = 0;
+  int _hessianUpdates = 0;
   std::vector<std::string> _availableSolvationModels = std::vector<std::string>{"gbsa"};
-  bool _setExternalCharges = false;
-  void _cleanDataStructures(xtb_TEnvironment& env, xtb_TCalculator& calc, xtb_TResults& res, xtb_TMolecule& mol);
-  void setExternalCharges(xtb_TEnvironment& env, xtb_TCalculator& calc, xtb_TResults& res, xtb_TMolecule& mol);
+  /**
+   * @brief Loads the parametrization of the method into the calculator of the session.
+   * @param session The session to be parametrized.
+   */
+  virtual void _loadMethod(XtbSession& session) = 0;
+  /**
+   * @brief Estimates the memory held by xtb for a single point of the method.
+   * @param nAtoms The number of atoms.
+   * @param nAos   The number of atomic orbitals.
+   * @return double The estimated memory in bytes.
+   */
+  virtual double _estimateMethodMemory(int nAtoms, int nAos) const = 0;
+  /**
+   * @brief Determines the properties to be calculated within the memory limit.
+   * @throws std::runtime_error if the memory limit cannot be met.
+   */
+  void _applyMemoryLimit();
+  /// @brief Starts the clock of the time limit of a calculation.
+  void _startClock();
+  /**
+   * @brief Runs the single point of the session, with the SCF convergence
+   *        recovery if it is enabled.
+   *
+   * All attempts run within the session, such that each one starts from the
+   * (possibly unconverged) wavefunction of the previous one. The attempts are
+   * recorded in the calculation info.
+   *
+   * @param session The session of the current structure.
+   * @throws Core::UnsuccessfulCalculationException if no attempt converged.
+   */
+  void _singlepoint(XtbSession& session);
+  /**
+   * @brief Prepares the session, runs the single point for the current
+   *        positions and calls the given function to extract the results,
+   *        collecting the captured output in either case.
+   */
+  void _runSinglepoint(XtbSession& session, const std::function<void()>& extract);
+  /**
+   * @brief Calculates the Hessian by finite differences of the gradients,
+   *        checking for cancellation between the displacements.
+   *
+   * All displacements are run within the given session, such that each SCF
+   * starts from the wavefunction of the previous displacement. The session is
+   * returned at the reference positions.
+   *
+   * @param session The session of the current structure.
+   * @return Utils::HessianMatrix The Hessian.
+   */
+  Utils::HessianMatrix _calculateHessian(XtbSession& session);
+  /**
+   * @brief Provides the Hessian of the current structure, either by updating
+   *        the last Hessian with the gradients of the session or exactly.
+   *
+   * The update is rejected in favor of an exact Hessian if the structure
+   * changed, if the maximum number of consecutive updates is reached, or if
+   * the last Hessian predicted the change of the gradients poorly.
+   *
+   * @param session The session of the current structure.
+   * @return Utils::HessianMatrix The Hessian.
+   */
+  Utils::HessianMatrix _provideHessian(XtbSession& session);
+  /// @brief The number of valence electrons, i.e. those in the orbitals of xtb, of the current structure and charge.
+  int _numberOfElectrons() const;
+  /// @brief Counts the electrons and orbitals of the given elements, without touching the cache of verifyPesValidity().
+  ElectronAndAoCounts _countElectronsAndAos(const Utils::ElementTypeCollection& elements) const;
+  /**
+   * @brief Validates the settings and the charge and multiplicity of the
+   *        current structure, unless neither changed since the last validation.
+   * @throws std::runtime_error if the settings or the structure are invalid.
+   */
+  void _validate();
+  /**
+   * @brief The fingerprint of the current structure and of all settings that
+   *        affect a single point, used to match restart files.
+   */
+  std::uint64_t _fingerprint() const;
+  /// @brief The HOMO-LUMO gap of the aufbau occupation of the given orbital energies.
+  double _homoLumoGap(const Eigen::VectorXd& orbitalEnergies) const;
+  /// @brief The path of the restart file of the current calculation, empty if restart files are disabled.
+  std::string _restartPath() const;
+  /**
+   * @brief Fills the results from a matching restart file.
+   * @return bool True if a restart file with all required properties was found.
+   */
+  bool _readRestart();
+  /**
+   * @brief Writes the restart file of the last single point of the given session.
+   * @param session The session holding a converged single point.
+   */
+  void _writeRestart(XtbSession& session);
+  /**
+   * @brief Moves the captured output of the session into the calculation info
+   *        and passes it to the output sink.
+   * @param session The session of the calculation.
+   * @param failed  Whether the calculation failed.
+   */
+  void _collectOutput(XtbSession& session, bool failed);
+  void _applySettings(XtbSession& session);
+  void _setExternalCharges(XtbSession& session);
+  void _setSolvation(XtbSession& session);
+  /**
+   * @brief Fills the results with all required properties of the last single
+   *        point of the given session.
+   * @param session The session holding a converged single point.
+   */
+  void _parseResults(XtbSession& session);
   std::map<Utils::ElementType, std::pair<int, int>> _nElectronsAndAos = {
       {Utils::ElementType::H, {1, 1}},   {Utils::ElementType::He, {2, 4}},  {Utils::ElementType::Li, {1, 4}},
       {Utils::ElementType::Be, {2, 4}},  {Utils::ElementType::B, {3, 4}},   {Utils::ElementType::C, {4, 4}},
@@ -0,0 +1,131 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Wrapper/XtbExecutor.h"
+#include "Xtb/Wrapper/XtbCalculatorBase.h"
+/* External Includes */
+#include <stdexcept>
+
+namespace Scine {
+namespace Xtb {
+
+XtbExecutor::XtbExecutor(int numberOfWorkers, int queueCapacity) : _queueCapacity(queueCapacity) {
+  if (numberOfWorkers < 1 || queueCapacity < 1) {
+    throw std::invalid_argument("The xtb executor needs at least one worker and a queue capacity of at least one.");
+  }
+  for (int i = 0; i < numberOfWorkers; ++i) {
+    _workers.emplace_back(&XtbExecutor::_work, this);
+  }
+}
+
+XtbExecutor::~XtbExecutor() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _taskAvailable.notify_all();
+  for (auto& worker : _workers) {
+    worker.join();
+  }
+}
+
+std::future<Utils::Results> XtbExecutor::submit(std::shared_ptr<XtbCalculatorBase> calculator, Callback callback) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  _spaceAvailable.wait(lock, [this] { return static_cast<int>(_queue.size()) < _queueCapacity; });
+  return _enqueue(lock, std::move(calculator), std::move(callback));
+}
+
+bool XtbExecutor::trySubmit(std::shared_ptr<XtbCalculatorBase> calculator, std::future<Utils::Results>& future,
+                            Callback callback) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  if (static_cast<int>(_queue.size()) >= _queueCapacity) {
+    return false;
+  }
+  future = _enqueue(lock, std::move(calculator), std::move(callback));
+  return true;
+}
+
+void XtbExecutor::wait() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  _finished.wait(lock, [this] { return _pending == 0; });
+}
+
+int XtbExecutor::pending() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _pending;
+}
+
+int XtbExecutor::numberOfWorkers() const {
+  return static_cast<int>(_workers.size());
+}
+
+int XtbExecutor::queueCapacity() const {
+  return _queueCapacity;
+}
+
+std::future<Utils::Results> XtbExecutor::_enqueue(std::unique_lock<std::mutex>& lock,
+                                                  std::shared_ptr<XtbCalculatorBase> calculator, Callback callback) {
+  if (!calculator) {
+    throw std::invalid_argument("Cannot submit an empty calculator to the xtb executor.");
+  }
+  Task task;
+  task.calculator = std::move(calculator);
+  task.callback = std::move(callback);
+  auto future = task.promise.get_future();
+  _queue.push_back(std::move(task));
+  ++_pending;
+  lock.unlock();
+  _taskAvailable.notify_one();
+  return future;
+}
+
+void XtbExecutor::_work() {
+  while (true) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _taskAvailable.wait(lock, [this] { return !_queue.empty() || _stop; });
+    if (_queue.empty()) {
+      return;
+    }
+    Task task = std::move(_queue.front());
+    _queue.pop_front();
+    lock.unlock();
+    _spaceAvailable.notify_one();
+
+    Utils::Results results;
+    std::exception_ptr error = nullptr;
+    try {
+      results = task.calculator->calculate("");
+    }
+    catch (...) {
+      error = std::current_exception();
+    }
+    // Release the calculator (and its memory) before reporting the completion
+    task.calculator.reset();
+    if (error) {
+      task.promise.set_exception(error);
+    }
+    else {
+      task.promise.set_value(results);
+    }
+    if (task.callback) {
+      try {
+        task.callback(error ? Utils::Results() : results, error);
+      }
+      catch (...) {
+      }
+    }
+
+    lock.lock();
+    --_pending;
+    lock.unlock();
+    _finished.notify_all();
+  }
+}
+
+} /* namespace Xtb */
+} /* namespace Scine */
@@ -0,0 +1,105 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_XTBEXECUTOR_H_
+#define XTB_XTBEXECUTOR_H_
+
+/* External Includes */
+#include <Utils/CalculatorBasics.h>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Scine {
+namespace Xtb {
+
+class XtbCalculatorBase;
+
+/**
+ * @class XtbExecutor
+ * @brief A pool of worker threads running xtb calculations asynchronously.
+ *
+ * Calculations are queued in a bounded queue. If the queue is full, submit()
+ * blocks until a worker takes the next calculation, which propagates the
+ * backpressure to the submitting code; trySubmit() returns immediately
+ * instead. Each calculation uses the number of OpenMP threads of its own
+ * calculator settings.
+ */
+class XtbExecutor {
+ public:
+  /**
+   * @brief The completion callback, called on the worker thread with the
+   *        results or, if the calculation failed, with empty results and the
+   *        exception. Exceptions thrown by the callback are discarded.
+   */
+  using Callback = std::function<void(const Utils::Results&, std::exception_ptr)>;
+  /**
+   * @brief Constructor, starts the workers.
+   * @param numberOfWorkers The number of concurrent calculations.
+   * @param queueCapacity   The maximum number of queued (not yet started) calculations.
+   */
+  XtbExecutor(int numberOfWorkers, int queueCapacity);
+  /// @brief Destructor, finishes all queued calculations and stops the workers.
+  ~XtbExecutor();
+  XtbExecutor(const XtbExecutor&) = delete;
+  XtbExecutor& operator=(const XtbExecutor&) = delete;
+  /**
+   * @brief Queues a calculation, blocking while the queue is full.
+   * @param calculator The calculator, holding the structure, settings and required properties.
+   *                   It must not be modified until the calculation is finished.
+   * @param callback   The optional completion callback.
+   * @return std::future<Utils::Results> The results of the calculation.
+   */
+  std::future<Utils::Results> submit(std::shared_ptr<XtbCalculatorBase> calculator, Callback callback = nullptr);
+  /**
+   * @brief Queues a calculation if the queue is not full.
+   * @param calculator The calculator, see submit().
+   * @param future     Set to the results of the calculation if it was queued.
+   * @param callback   The optional completion callback.
+   * @return bool False if the queue is full.
+   */
+  bool trySubmit(std::shared_ptr<XtbCalculatorBase> calculator, std::future<Utils::Results>& future,
+                 Callback callback = nullptr);
+  /// @brief Blocks until all submitted calculations and their callbacks are finished.
+  void wait();
+  /// @brief The number of submitted calculations that are not yet finished.
+  int pending() const;
+  /// @brief The number of concurrent calculations.
+  int numberOfWorkers() const;
+  /// @brief The maximum number of queued calculations.
+  int queueCapacity() const;
+
+ private:
+  struct Task {
+    std::shared_ptr<XtbCalculatorBase> calculator;
+    std::promise<Utils::Results> promise;
+    Callback callback;
+  };
+  std::future<Utils::Results> _enqueue(std::unique_lock<std::mutex>& lock,
+                                       std::shared_ptr<XtbCalculatorBase> calculator, Callback callback);
+  void _work();
+
+  const int _queueCapacity;
+  mutable std::mutex _mutex;
+  std::condition_variable _taskAvailable;
+  std::condition_variable _spaceAvailable;
+  std::condition_variable _finished;
+  std::deque<Task> _queue;
+  int _pending = 0;
+  bool _stop = false;
+  std::vector<std::thread> _workers;
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_XTBEXECUTOR_H_ */
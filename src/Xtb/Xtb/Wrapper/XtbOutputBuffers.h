@@ -0,0 +1,32 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_XTBOUTPUTBUFFERS_H_
+#define XTB_XTBOUTPUTBUFFERS_H_
+
+namespace Scine {
+namespace Xtb {
+
+/**
+ * @struct XtbOutputBuffers
+ * @brief Caller-owned memory the results of a single point are written into.
+ *
+ * Each non-null buffer is filled directly by xtb, null buffers are not
+ * requested. The buffers have to stay valid during the calculation.
+ */
+struct XtbOutputBuffers {
+  /// @brief The energy in hartree, one double.
+  double* energy = nullptr;
+  /// @brief The gradients in hartree/bohr, 3N doubles in the atom-major order of a Utils::GradientCollection.
+  double* gradients = nullptr;
+  /// @brief The atomic partial charges, N doubles.
+  double* atomicCharges = nullptr;
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_XTBOUTPUTBUFFERS_H_ */
@@ -0,0 +1,135 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Wrapper/XtbRestartFile.h"
+/* External Includes */
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#ifdef _WIN32
+#  include <process.h>
+#else
+#  include <unistd.h>
+#endif
+
+namespace Scine {
+namespace Xtb {
+
+namespace {
+constexpr char magic[8] = {'S', 'C', 'X', 'T', 'B', 'R', 'S', 'T'};
+
+template<class T>
+void writeValue(std::ostream& out, const T& value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<class T>
+bool readValue(std::istream& in, T& value) {
+  return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+void writeBlock(std::ostream& out, const double* data, std::int64_t size) {
+  writeValue(out, size);
+  out.write(reinterpret_cast<const char*>(data), size * sizeof(double));
+}
+
+bool readBlock(std::istream& in, std::vector<double>& data) {
+  std::int64_t size = 0;
+  // Guard against corrupt sizes before allocating
+  if (!readValue(in, size) || size < 0 || size > (std::int64_t(1) << 34)) {
+    return false;
+  }
+  data.resize(size);
+  return static_cast<bool>(in.read(reinterpret_cast<char*>(data.data()), size * sizeof(double)));
+}
+
+// A name next to the path that no other writer uses, so that the rename stays on the same file system
+std::string temporaryPath(const std::string& path) {
+#ifdef _WIN32
+  const int pid = _getpid();
+#else
+  const int pid = static_cast<int>(getpid());
+#endif
+  std::random_device device;
+  std::ostringstream name;
+  name << path << "." << pid << "." << std::hex << std::setfill('0') << std::setw(8) << device() << std::setw(8)
+       << device() << ".tmp";
+  return name.str();
+}
+} // namespace
+
+void XtbRestartFile::write(const std::string& path) const {
+  const std::string temporary = temporaryPath(path);
+  {
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    out.write(magic, sizeof(magic));
+    writeValue(out, version);
+    writeValue(out, fingerprint);
+    writeValue(out, static_cast<std::int32_t>(nAtoms));
+    writeValue(out, energy);
+    writeBlock(out, gradients.data(), gradients.size());
+    writeBlock(out, atomicCharges.data(), atomicCharges.size());
+    writeBlock(out, dipole.data(), dipole.size());
+    writeBlock(out, orbitalEnergies.data(), orbitalEnergies.size());
+    writeBlock(out, orbitalOccupations.data(), orbitalOccupations.size());
+    if (!out) {
+      std::remove(temporary.c_str());
+      throw std::runtime_error("Could not write the XTB restart file '" + path + "'.");
+    }
+  }
+  // Readers in other processes never see a partially written file, and concurrent writers of the same path
+  // each rename a complete file of their own
+  if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+    std::remove(temporary.c_str());
+    throw std::runtime_error("Could not write the XTB restart file '" + path + "'.");
+  }
+}
+
+bool XtbRestartFile::read(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return false;
+  }
+  char fileMagic[sizeof(magic)];
+  std::uint32_t fileVersion = 0;
+  std::int32_t fileAtoms = 0;
+  if (!in.read(fileMagic, sizeof(fileMagic)) || std::memcmp(fileMagic, magic, sizeof(magic)) != 0 ||
+      !readValue(in, fileVersion) || fileVersion != version || !readValue(in, fingerprint) ||
+      !readValue(in, fileAtoms) || !readValue(in, energy)) {
+    return false;
+  }
+  nAtoms = fileAtoms;
+  std::vector<double> block;
+  if (!readBlock(in, block) || (!block.empty() && static_cast<int>(block.size()) != 3 * nAtoms)) {
+    return false;
+  }
+  gradients = Eigen::Map<Utils::GradientCollection>(block.data(), block.size() / 3, 3);
+  if (!readBlock(in, atomicCharges)) {
+    return false;
+  }
+  if (!readBlock(in, block)) {
+    return false;
+  }
+  dipole = Eigen::Map<Eigen::VectorXd>(block.data(), block.size());
+  if (!readBlock(in, block)) {
+    return false;
+  }
+  orbitalEnergies = Eigen::Map<Eigen::VectorXd>(block.data(), block.size());
+  if (!readBlock(in, block)) {
+    return false;
+  }
+  orbitalOccupations = Eigen::Map<Eigen::VectorXd>(block.data(), block.size());
+  return true;
+}
+
+} /* namespace Xtb */
+} /* namespace Scine */
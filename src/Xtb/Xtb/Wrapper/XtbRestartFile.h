@@ -0,0 +1,70 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_XTBRESTARTFILE_H_
+#define XTB_XTBRESTARTFILE_H_
+
+/* External Includes */
+#include <Utils/Typenames.h>
+#include <Eigen/Core>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Scine {
+namespace Xtb {
+
+/**
+ * @struct XtbRestartFile
+ * @brief The content of a binary restart file of a converged single point.
+ *
+ * The restart files are a cache of results: the file is tagged with a
+ * fingerprint of the structure and of all settings that affect the single
+ * point, such that its results are only returned for an identical
+ * calculation. No SCF is started from it, the C API of xtb does not accept an
+ * initial guess. Optional blocks (e.g. the gradients or the orbital
+ * data of force fields) are stored with zero length if they are not available.
+ *
+ * Layout (native byte order): the magic bytes 'SCXTBRST', the format version
+ * (uint32), the fingerprint (uint64), the number of atoms (int32), the energy
+ * (double), followed by the gradients, atomic charges, dipole, orbital
+ * energies and orbital occupations, each as a length
+ * (int64) followed by that many doubles.
+ */
+struct XtbRestartFile {
+  /// @brief The version of the file format, files of other versions are ignored.
+  static constexpr std::uint32_t version = 2;
+  std::uint64_t fingerprint = 0;
+  int nAtoms = 0;
+  double energy = 0.0;
+  /// @brief The gradients, empty if they were not calculated.
+  Utils::GradientCollection gradients;
+  /// @brief The atomic charges, empty if they were not calculated.
+  std::vector<double> atomicCharges;
+  /// @brief The dipole, empty if it was not calculated.
+  Eigen::VectorXd dipole;
+  /// @brief The orbital energies, empty for force fields.
+  Eigen::VectorXd orbitalEnergies;
+  /// @brief The Fermi smeared orbital occupations, empty for force fields.
+  Eigen::VectorXd orbitalOccupations;
+  /**
+   * @brief Writes the restart file, replacing an existing file atomically.
+   * @param path The path of the file.
+   * @throws std::runtime_error If the file cannot be written.
+   */
+  void write(const std::string& path) const;
+  /**
+   * @brief Reads a restart file.
+   * @param path The path of the file.
+   * @return bool False if the file does not exist, is of a different version or is corrupt.
+   */
+  bool read(const std::string& path);
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_XTBRESTARTFILE_H_ */
@@ -0,0 +1,325 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+/* Internal Includes */
+#include "Xtb/Wrapper/XtbSession.h"
+/* External Includes */
+#include <Core/Exceptions.h>
+#include <Utils/Geometry/ElementInfo.h>
+#include <boost/exception/diagnostic_information.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <utility>
+
+namespace Scine {
+namespace Xtb {
+
+namespace {
+Eigen::VectorXi atomicNumbers(const Utils::AtomCollection& structure) {
+  const auto& elements = structure.getElements();
+  Eigen::VectorXi attyp(structure.size());
+  for (int i = 0; i < structure.size(); i++) {
+    attyp[i] = Utils::ElementInfo::Z(elements[i]);
+  }
+  return attyp;
+}
+} // namespace
+
+XtbSession::XtbSession(const Utils::AtomCollection& structure, double charge, int uhf)
+  : _nAtoms(structure.size()),
+    _elements(structure.getElements()),
+    _charge(charge),
+    _uhf(uhf),
+    _accuracy(std::numeric_limits<double>::quiet_NaN()),
+    _electronicTemperature(std::numeric_limits<double>::quiet_NaN()),
+    _solventTemperature(std::numeric_limits<double>::quiet_NaN()) {
+  const Eigen::VectorXi attyp = atomicNumbers(structure);
+  const auto& coord = structure.getPositions();
+  _env = xtb_newEnvironment();
+  _calc = xtb_newCalculator();
+  _res = xtb_newResults();
+  _mol = xtb_newMolecule(_env, &_nAtoms, attyp.data(), coord.data(), &charge, &uhf, nullptr, nullptr);
+  _checkMolecule();
+}
+
+XtbSession::XtbSession(const Utils::AtomCollection& structure, double charge, int uhf, const Eigen::Matrix3d& lattice,
+                       std::array<bool, 3> periodicity)
+  : _nAtoms(structure.size()),
+    _elements(structure.getElements()),
+    _periodic(true),
+    _lattice(lattice.transpose()),
+    _charge(charge),
+    _uhf(uhf),
+    _accuracy(std::numeric_limits<double>::quiet_NaN()),
+    _electronicTemperature(std::numeric_limits<double>::quiet_NaN()),
+    _solventTemperature(std::numeric_limits<double>::quiet_NaN()) {
+  const Eigen::VectorXi attyp = atomicNumbers(structure);
+  const auto& coord = structure.getPositions();
+  const bool periodic[3] = {periodicity[0], periodicity[1], periodicity[2]};
+  _env = xtb_newEnvironment();
+  _calc = xtb_newCalculator();
+  _res = xtb_newResults();
+  _mol = xtb_newMolecule(_env, &_nAtoms, attyp.data(), coord.data(), &charge, &uhf, _lattice.data(), &periodic[0]);
+  _checkMolecule();
+}
+
+void XtbSession::_checkMolecule() {
+  if (xtb_checkEnvironment(_env) != 0) {
+    const std::string errorMessage = _errorMessage();
+    xtb_delResults(&_res);
+    xtb_delCalculator(&_calc);
+    xtb_delMolecule(&_mol);
+    xtb_delEnvironment(&_env);
+    throw Core::UnsuccessfulCalculationException("XTB molecule setup failed.\n" + errorMessage);
+  }
+}
+
+XtbSession::~XtbSession() {
+  if (_externalCharges) {
+    xtb_releaseExternalCharges(_env, _calc);
+  }
+  if (!_outputPath.empty()) {
+    xtb_releaseOutput(_env);
+    std::remove(_outputPath.c_str());
+  }
+  xtb_delResults(&_res);
+  xtb_delCalculator(&_calc);
+  xtb_delMolecule(&_mol);
+  xtb_delEnvironment(&_env);
+}
+
+void XtbSession::checkEnvironment(const std::string& message) {
+  if (xtb_checkEnvironment(_env) == 0) {
+    return;
+  }
+  std::string errorMessage = _errorMessage();
+  if (_outputPath.empty()) {
+    xtb_showEnvironment(_env, nullptr);
+  }
+  else if (!getOutput().empty()) {
+    errorMessage += (errorMessage.empty() ? "" : "\n") + std::string("XTB output:\n") + _output;
+  }
+  if (errorMessage.empty()) {
+    throw Core::UnsuccessfulCalculationException(message);
+  }
+  throw Core::UnsuccessfulCalculationException(message + "\n" + errorMessage);
+}
+
+std::string XtbSession::_errorMessage() {
+  // The error stack is truncated to the buffer, which holds several nested messages
+  const int buffersize = 8192;
+  std::vector<char> error(buffersize, '\0');
+  xtb_getError(_env, error.data(), &buffersize);
+  return std::string(error.data());
+}
+
+void XtbSession::captureOutput(std::size_t capacity) {
+  if (_outputPath.empty()) {
+    std::random_device device;
+    std::ostringstream name;
+    name << "scine_xtb_" << std::hex << std::setfill('0') << std::setw(8) << device() << std::setw(8) << device()
+         << ".out";
+    _outputPath = (std::filesystem::temp_directory_path() / name.str()).string();
+    xtb_setOutput(_env, _outputPath.c_str());
+  }
+  _outputCapacity = capacity;
+}
+
+const std::string& XtbSession::getOutput() {
+  _collectOutput();
+  return _output;
+}
+
+void XtbSession::clearOutput() {
+  _collectOutput();
+  _output.clear();
+}
+
+void XtbSession::_collectOutput() {
+  if (_outputPath.empty()) {
+    return;
+  }
+  // Closing the output unit flushes it, the file is truncated by reopening it
+  xtb_releaseOutput(_env);
+  {
+    std::ifstream file(_outputPath, std::ios::binary | std::ios::ate);
+    if (file) {
+      const std::streamoff size = file.tellg();
+      const std::streamoff start = std::max<std::streamoff>(0, size - static_cast<std::streamoff>(_outputCapacity));
+      std::string chunk(static_cast<std::size_t>(size - start), '\0');
+      file.seekg(start);
+      file.read(&chunk[0], chunk.size());
+      _output += chunk;
+    }
+  }
+  if (_output.size() > _outputCapacity) {
+    _output.erase(0, _output.size() - _outputCapacity);
+  }
+  std::remove(_outputPath.c_str());
+  xtb_setOutput(_env, _outputPath.c_str());
+}
+
+void XtbSession::updatePositions(const Utils::PositionCollection& positions) {
+  if (positions.rows() != _nAtoms) {
+    throw std::runtime_error("The number of positions does not match the number of atoms in the xtb session.");
+  }
+  xtb_updateMolecule(_env, _mol, positions.data(), _periodic ? _lattice.data() : nullptr);
+  checkEnvironment("XTB molecule update failed.");
+}
+
+void XtbSession::setSelfConsistenceCriterion(double criterion) {
+  if (criterion == _accuracy) {
+    return;
+  }
+  xtb_setAccuracy(_env, _calc, criterion / 1e-6); // to arrive at Xtb accuracy value
+  _accuracy = criterion;
+}
+
+void XtbSession::setMaxIterations(int maxIterations) {
+  if (maxIterations == _maxIterations) {
+    return;
+  }
+  xtb_setMaxIter(_env, _calc, maxIterations);
+  _maxIterations = maxIterations;
+}
+
+void XtbSession::setElectronicTemperature(double temperature) {
+  if (temperature == _electronicTemperature) {
+    return;
+  }
+  xtb_setElectronicTemp(_env, _calc, temperature);
+  _electronicTemperature = temperature;
+}
+
+void XtbSession::setVerbosity(int verbosity) {
+  if (verbosity == _verbosity) {
+    return;
+  }
+  xtb_setVerbosity(_env, verbosity);
+  _verbosity = verbosity;
+}
+
+void XtbSession::setSolvent(const std::string& solvent, double temperature, int gridPoints) {
+  if (solvent == _solvent &&
+      (solvent.empty() || (temperature == _solventTemperature && gridPoints == _solventGridPoints))) {
+    return;
+  }
+  if (solvent.empty()) {
+    xtb_releaseSolvent(_env, _calc);
+  }
+  else {
+    std::string name = solvent;
+    int state = 3; // 1 bar of ideal gas and 1 mol/L of liquid solution
+    xtb_setSolvent(_env, _calc, &name[0], &state, &temperature, &gridPoints);
+  }
+  checkEnvironment("XTB solvation setup failed.");
+  _solvent = solvent;
+  _solventTemperature = temperature;
+  _solventGridPoints = gridPoints;
+}
+
+void XtbSession::clearExternalCharges() {
+  if (_externalCharges) {
+    xtb_releaseExternalCharges(_env, _calc);
+    _externalCharges = false;
+  }
+  _externalAtomicNumbers.clear();
+  _externalChargeValues.clear();
+  _externalPositions.resize(0, 3);
+}
+
+void XtbSession::setExternalCharges(std::vector<int> atomicNumbers, std::vector<double> charges,
+                                    Utils::PositionCollection positions) {
+  if (_externalCharges && atomicNumbers == _externalAtomicNumbers && charges == _externalChargeValues &&
+      positions.rows() == _externalPositions.rows() && positions == _externalPositions) {
+    return;
+  }
+  clearExternalCharges();
+  auto nEntries = static_cast<int>(charges.size());
+  xtb_setExternalCharges(_env, _calc, &nEntries, atomicNumbers.data(), charges.data(), positions.data());
+  _externalCharges = true;
+  checkEnvironment("Setting the XTB external charges failed.");
+  // Kept only once xtb accepted them, a failed call is never skipped later
+  _externalAtomicNumbers = std::move(atomicNumbers);
+  _externalChargeValues = std::move(charges);
+  _externalPositions = std::move(positions);
+}
+
+void XtbSession::singlepoint() {
+  try {
+    xtb_singlepoint(_env, _mol, _calc, _res);
+  }
+  catch (...) {
+    throw Core::UnsuccessfulCalculationException("Xtb calculation failed:\n" +
+                                                 boost::current_exception_diagnostic_information());
+  }
+  checkEnvironment("Xtb calculation failed:");
+}
+
+double XtbSession::getEnergy() {
+  double energy = 0.0;
+  xtb_getEnergy(_env, _res, &energy);
+  checkEnvironment("Could not read XTB energy.");
+  return energy;
+}
+
+Utils::GradientCollection XtbSession::getGradients() {
+  Utils::GradientCollection grad = Utils::GradientCollection::Zero(_nAtoms, 3);
+  getGradients(grad.data());
+  return grad;
+}
+
+void XtbSession::getGradients(double* gradients) {
+  xtb_getGradient(_env, _res, gradients);
+  checkEnvironment("Could not read XTB gradients.");
+}
+
+void XtbSession::getCharges(double* charges) {
+  xtb_getCharges(_env, _res, charges);
+  checkEnvironment("Could not read XTB partial charges.");
+}
+
+Eigen::Matrix3d XtbSession::getVirial() {
+  Eigen::Matrix3d virial = Eigen::Matrix3d::Zero();
+  xtb_getVirial(_env, _res, virial.data());
+  checkEnvironment("Could not read XTB virial.");
+  return virial;
+}
+
+Utils::Dipole XtbSession::getDipole() {
+  Utils::Dipole dipole = Utils::Dipole::Zero();
+  xtb_getDipole(_env, _res, dipole.data());
+  checkEnvironment("Could not read XTB dipole.");
+  return dipole;
+}
+
+Eigen::VectorXd XtbSession::getOrbitalEnergies() {
+  int nAos = 0;
+  xtb_getNao(_env, _res, &nAos);
+  Eigen::VectorXd energies = Eigen::VectorXd::Zero(nAos);
+  xtb_getOrbitalEigenvalues(_env, _res, energies.data());
+  checkEnvironment("Could not read XTB orbital energies.");
+  return energies;
+}
+
+Eigen::VectorXd XtbSession::getOrbitalOccupations() {
+  int nAos = 0;
+  xtb_getNao(_env, _res, &nAos);
+  Eigen::VectorXd occupations = Eigen::VectorXd::Zero(nAos);
+  xtb_getOrbitalOccupations(_env, _res, occupations.data());
+  checkEnvironment("Could not read XTB orbital occupations.");
+  return occupations;
+}
+
+} /* namespace Xtb */
+} /* namespace Scine */
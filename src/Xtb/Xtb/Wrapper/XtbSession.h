@@ -0,0 +1,246 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Department of Chemistry and Applied Biosciences, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#ifndef XTB_XTBSESSION_H_
+#define XTB_XTBSESSION_H_
+
+/* External Includes */
+#include <Utils/Geometry/AtomCollection.h>
+#include <Utils/Typenames.h>
+#include <xtb.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Scine {
+namespace Xtb {
+
+/**
+ * @class XtbSession
+ * @brief Owns the handles of one xtb calculation (environment, molecule,
+ *        calculator and results).
+ *
+ * The handles are released upon destruction. As long as a session is alive,
+ * the loaded parametrization and the last converged wavefunction (which xtb
+ * keeps within the results handle) are kept, so that consecutive single points
+ * on updated positions restart the SCF from the previous density instead of
+ * starting from scratch.
+ *
+ * By default, xtb writes its output and error stack to stdout. With
+ * captureOutput(), the output is redirected into a private file and collected
+ * into a bounded buffer instead, which is attached to the exceptions of failed
+ * calculations.
+ */
+class XtbSession {
+ public:
+  /**
+   * @brief Creates the xtb environment, calculator, results and molecule.
+   * @param structure The structure of the molecule.
+   * @param charge    The molecular charge.
+   * @param uhf       The number of unpaired electrons.
+   * @throws Core::UnsuccessfulCalculationException If xtb rejects the molecule.
+   */
+  XtbSession(const Utils::AtomCollection& structure, double charge, int uhf);
+  /**
+   * @brief Creates the xtb environment, calculator, results and a periodic molecule.
+   * @param structure   The structure of the molecule.
+   * @param charge      The molecular charge.
+   * @param uhf         The number of unpaired electrons.
+   * @param lattice     The cell in bohr, each row is a lattice vector.
+   * @param periodicity Whether the system is periodic along each lattice vector.
+   * @throws Core::UnsuccessfulCalculationException If xtb rejects the molecule.
+   */
+  XtbSession(const Utils::AtomCollection& structure, double charge, int uhf, const Eigen::Matrix3d& lattice,
+             std::array<bool, 3> periodicity);
+  /// @brief Releases all xtb handles.
+  ~XtbSession();
+  XtbSession(const XtbSession& other) = delete;
+  XtbSession& operator=(const XtbSession& other) = delete;
+
+  /// @brief Accessor for the xtb environment.
+  xtb_TEnvironment& environment() {
+    return _env;
+  }
+  /// @brief Accessor for the xtb molecule.
+  xtb_TMolecule& molecule() {
+    return _mol;
+  }
+  /// @brief Accessor for the xtb calculator.
+  xtb_TCalculator& calculator() {
+    return _calc;
+  }
+  /// @brief Accessor for the xtb results.
+  xtb_TResults& results() {
+    return _res;
+  }
+  /// @brief Whether the molecule of this session is periodic.
+  bool isPeriodic() const {
+    return _periodic;
+  }
+  /// @brief The number of atoms in the molecule of this session.
+  int size() const {
+    return _nAtoms;
+  }
+  /// @brief The elements of the molecule of this session.
+  const Utils::ElementTypeCollection& getElements() const {
+    return _elements;
+  }
+  /**
+   * @brief Throws if the xtb environment holds an error.
+   * @param message The message of the exception, the error of xtb is appended.
+   * @throws Core::UnsuccessfulCalculationException
+   */
+  void checkEnvironment(const std::string& message);
+  /**
+   * @brief Redirects the output of xtb from stdout into a bounded buffer.
+   * @param capacity The maximum number of bytes kept, older output is dropped.
+   */
+  void captureOutput(std::size_t capacity);
+  /// @brief Whether the output of xtb is captured.
+  bool isCapturingOutput() const {
+    return !_outputPath.empty();
+  }
+  /**
+   * @brief The captured output of xtb since the last clearOutput(), at most the
+   *        last capacity bytes. Empty if the output is not captured.
+   */
+  const std::string& getOutput();
+  /// @brief Discards the captured output.
+  void clearOutput();
+  /**
+   * @brief Updates the positions of the molecule, keeping the wavefunction.
+   * @param positions The new positions in bohr.
+   */
+  void updatePositions(const Utils::PositionCollection& positions);
+  /**
+   * @brief Sets the SCF convergence of the calculator.
+   *
+   * This and the following setters skip the call into xtb if the value is the
+   * one of the previous call.
+   *
+   * @param criterion The energy accuracy in hartree, it is mapped onto the
+   *                  accuracy value of xtb (which also scales the integral cutoffs).
+   */
+  void setSelfConsistenceCriterion(double criterion);
+  /// @brief Sets the maximum number of SCF iterations.
+  void setMaxIterations(int maxIterations);
+  /// @brief Sets the electronic temperature in kelvin.
+  void setElectronicTemperature(double temperature);
+  /// @brief Sets the verbosity of the output of xtb.
+  void setVerbosity(int verbosity);
+  /**
+   * @brief Sets the GBSA solvent of the calculator.
+   *
+   * The solvation model is kept for all following single points of the
+   * session, only the surface and the Born radii are updated with the positions.
+   *
+   * @param solvent     The lower case solvent name, empty to remove the solvation.
+   * @param temperature The temperature of the solvation free energy in kelvin.
+   * @param gridPoints  The number of Lebedev grid points per atom of the surface.
+   */
+  void setSolvent(const std::string& solvent, double temperature, int gridPoints);
+  /**
+   * @brief Sets the external point charges of the calculator, replacing any previous ones.
+   *
+   * Like the setters above, this skips the call into xtb if the charges are the
+   * ones of the previous call.
+   *
+   * @param atomicNumbers The atomic numbers (used for the charge broadening).
+   * @param charges       The charges.
+   * @param positions     The positions of the charges in bohr.
+   */
+  void setExternalCharges(std::vector<int> atomicNumbers, std::vector<double> charges,
+                          Utils::PositionCollection positions);
+  /// @brief Removes the external point charges of the calculator.
+  void clearExternalCharges();
+  /// @brief The molecular charge the session was created with.
+  double getCharge() const {
+    return _charge;
+  }
+  /// @brief The number of unpaired electrons the session was created with.
+  int getUnpairedElectrons() const {
+    return _uhf;
+  }
+  /**
+   * @brief The generation of the calculator settings last applied to this
+   *        session, 0 if none were applied.
+   */
+  std::uint64_t getSettingsGeneration() const {
+    return _settingsGeneration;
+  }
+  /// @brief Setter for the generation of the calculator settings applied to this session.
+  void setSettingsGeneration(std::uint64_t generation) {
+    _settingsGeneration = generation;
+  }
+  /// @brief Whether external charges are set in the calculator of this session.
+  bool hasExternalCharges() const {
+    return _externalCharges;
+  }
+  /**
+   * @brief Runs a single point calculation for the current positions.
+   * @throws Core::UnsuccessfulCalculationException If the calculation failed.
+   */
+  void singlepoint();
+  /// @brief The energy of the last single point.
+  double getEnergy();
+  /// @brief The gradients of the last single point.
+  Utils::GradientCollection getGradients();
+  /// @brief Writes the gradients of the last single point into the given 3N doubles (atom-major).
+  void getGradients(double* gradients);
+  /// @brief Writes the atomic partial charges of the last single point into the given N doubles.
+  void getCharges(double* charges);
+  /// @brief The virial (the derivative of the energy with respect to the strain) of the last single point.
+  Eigen::Matrix3d getVirial();
+  /// @brief The dipole of the last single point in atomic units.
+  Utils::Dipole getDipole();
+  /// @brief The orbital energies of the last single point in hartree.
+  Eigen::VectorXd getOrbitalEnergies();
+  /// @brief The (Fermi smeared) occupation numbers of the orbitals of the last single point, between 0 and 2.
+  Eigen::VectorXd getOrbitalOccupations();
+
+ private:
+  void _checkMolecule();
+  // The error stack of the environment
+  std::string _errorMessage();
+  // Moves the output written by xtb into the buffer
+  void _collectOutput();
+  xtb_TEnvironment _env;
+  xtb_TCalculator _calc;
+  xtb_TResults _res;
+  xtb_TMolecule _mol;
+  int _nAtoms;
+  Utils::ElementTypeCollection _elements;
+  bool _periodic = false;
+  // The cell in the column-major layout expected by xtb
+  Eigen::Matrix3d _lattice;
+  bool _externalCharges = false;
+  // The external charges last passed to xtb, empty if none are set
+  std::vector<int> _externalAtomicNumbers;
+  std::vector<double> _externalChargeValues;
+  Utils::PositionCollection _externalPositions;
+  double _charge;
+  int _uhf;
+  // The values last passed to xtb, NaN and -1 if not set yet
+  double _accuracy;
+  int _maxIterations = -1;
+  double _electronicTemperature;
+  int _verbosity = -1;
+  std::string _solvent;
+  double _solventTemperature;
+  int _solventGridPoints = -1;
+  std::uint64_t _settingsGeneration = 0;
+  // The file xtb writes to if the output is captured, empty otherwise
+  std::string _outputPath;
+  std::size_t _outputCapacity = 0;
+  std::string _output;
+};
+
+} /* namespace Xtb */
+} /* namespace Scine */
+
+#endif /* XTB_XTBSESSION_H_ */
@@ -20,7 +20,27 @@
 namespace Scine {
 namespace Xtb {
 
-XtbSettings::XtbSettings() : Scine::Utils::Settings("XtbSettings") {
+namespace {
+// The team size of a default parallel region, detected once per process
+int defaultNumberOfThreads() {
+#if defined(_OPENMP)
+  static const int nThreads = omp_get_max_threads();
+  return nThreads;
+#else
+  return 1;
+#endif
+}
+} // namespace
+
+XtbSettings::XtbSettings() : XtbSettings(_schema()) {
+}
+
+const XtbSettings& XtbSettings::_schema() {
+  static const XtbSettings schema{Schema{}};
+  return schema;
+}
+
+XtbSettings::XtbSettings(Schema /* tag */) : Scine::Utils::Settings("XtbSettings") {
   using namespace Scine::Utils;
   using namespace Scine::Utils::UniversalSettings;
 
@@ -54,6 +74,20 @@ XtbSettings::XtbSettings() : Scine::Utils::Settings("XtbSettings") {
   prlevel.setDefaultValue(0);
   this->_fields.push_back("print_level", prlevel);
 
+  // Output
+  OptionListDescriptor outputMode("Where the output and the error messages of xtb go, 'stdout' or 'capture' into "
+                                  "a bounded buffer per calculation, which is attached to the calculation info and "
+                                  "to the exceptions of failed calculations.");
+  outputMode.addOption("stdout");
+  outputMode.addOption("capture");
+  outputMode.setDefaultOption("stdout");
+  this->_fields.push_back(XtbSettingsNames::outputMode, outputMode);
+
+  IntDescriptor outputBufferSize("The size of the buffer of the captured output in KiB, older output is dropped.");
+  outputBufferSize.setMinimum(1);
+  outputBufferSize.setDefaultValue(64);
+  this->_fields.push_back(XtbSettingsNames::outputBufferSize, outputBufferSize);
+
   // Accuracy
   DoubleDescriptor scfAcc("The energy accuracy used for XTB calculations. This settings automatically influences "
                           "integral cutoffs and wavefunction accuracy.");
@@ -72,6 +106,24 @@ XtbSettings::XtbSettings() : Scine::Utils::Settings("XtbSettings") {
   maxiter.setDefaultValue(100);
   this->_fields.push_back(SettingsNames::maxScfIterations, maxiter);
 
+  // SCF convergence recovery
+  BoolDescriptor scfRecovery("Whether an SCF that fails to converge is retried, first at the electronic temperature "
+                             "scf_recovery_temperature, then at the original temperature starting from the resulting "
+                             "wavefunction, and last with more iterations.");
+  scfRecovery.setDefaultValue(false);
+  this->_fields.push_back(XtbSettingsNames::scfRecovery, scfRecovery);
+
+  DoubleDescriptor scfRecoveryTemperature("The raised electronic temperature of the SCF convergence recovery in K.");
+  scfRecoveryTemperature.setMinimum(0.0);
+  scfRecoveryTemperature.setDefaultValue(3000.0);
+  this->_fields.push_back(XtbSettingsNames::scfRecoveryTemperature, scfRecoveryTemperature);
+
+  IntDescriptor scfRecoveryIterationFactor("The factor of the maximum number of SCF iterations of the last attempt "
+                                           "of the SCF convergence recovery.");
+  scfRecoveryIterationFactor.setMinimum(1);
+  scfRecoveryIterationFactor.setDefaultValue(3);
+  this->_fields.push_back(XtbSettingsNames::scfRecoveryIterationFactor, scfRecoveryIterationFactor);
+
   // Solvent
   StringDescriptor solvent("The implicit solvent to be used.");
   solvent.setDefaultValue("");
@@ -82,6 +134,14 @@ XtbSettings::XtbSettings() : Scine::Utils::Settings("XtbSettings") {
   solvation.setDefaultValue("");
   this->_fields.push_back(SettingsNames::solvation, solvation);
 
+  IntDescriptor solvationGridPoints("The number of Lebedev grid points per atom of the solvent accessible surface. "
+                                    "Smaller grids (e.g. 110 or 146) are faster, larger ones (e.g. 590 or 974) more "
+                                    "accurate.");
+  solvationGridPoints.setMinimum(6);
+  solvationGridPoints.setMaximum(5810);
+  solvationGridPoints.setDefaultValue(230);
+  this->_fields.push_back(XtbSettingsNames::solvationGridPoints, solvationGridPoints);
+
   // Temperature used for thermochemical calculations
   DoubleDescriptor thermTemp("The temperature used for the thermochemical calculation.");
   thermTemp.setMinimum(0.0);
@@ -105,14 +165,84 @@ XtbSettings::XtbSettings() : Scine::Utils::Settings("XtbSettings") {
                                        "charge, atomic_number, x, y, z coordinate.");
   this->_fields.push_back(SettingsNames::mmCharges, externalCharges);
 
+  // Periodic boundaries
+  StringDescriptor periodicBoundaries("The periodic boundaries given as 'a,b,c,alpha,beta,gamma' optionally followed "
+                                      "by the periodic directions (e.g. ',xyz'), with the lengths in bohr and the "
+                                      "angles in degrees. Empty for molecular calculations.");
+  periodicBoundaries.setDefaultValue("");
+  this->_fields.push_back(SettingsNames::periodicBoundaries, periodicBoundaries);
+
+  // Memory limit
+  IntDescriptor memoryLimit("The maximum estimated memory of a calculation in MiB, 0 for no limit.");
+  memoryLimit.setMinimum(0);
+  memoryLimit.setDefaultValue(0);
+  this->_fields.push_back(XtbSettingsNames::memoryLimit, memoryLimit);
+
+  OptionListDescriptor memoryLimitPolicy("What to do if the memory limit is exceeded: 'reject' the calculation or "
+                                         "'downgrade' it by skipping the Hessian, thermochemistry and bond orders.");
+  memoryLimitPolicy.addOption("reject");
+  memoryLimitPolicy.addOption("downgrade");
+  memoryLimitPolicy.setDefaultOption("reject");
+  this->_fields.push_back(XtbSettingsNames::memoryLimitPolicy, memoryLimitPolicy);
+
+  // Restart files
+  StringDescriptor restartDirectory("The directory of the binary restart files, a cache of results. Converged "
+                                    "single points are written to it and returned for identical calculations, also "
+                                    "across processes. Empty to disable restart files.");
+  restartDirectory.setDefaultValue("");
+  this->_fields.push_back(XtbSettingsNames::restartDirectory, restartDirectory);
+
+  // Time limit
+  DoubleDescriptor timeLimit("The wall-clock time limit of a calculation in seconds, 0 for no limit. It is checked "
+                             "between the phases of a calculation and between the displacements of the Hessian.");
+  timeLimit.setMinimum(0.0);
+  timeLimit.setDefaultValue(0.0);
+  this->_fields.push_back(XtbSettingsNames::timeLimit, timeLimit);
+
+  // Numerical Hessian
+  BoolDescriptor hessianSymmetry("Whether the numerical Hessian only displaces symmetry-unique atoms and directions "
+                                 "and reconstructs the remaining columns with the point group operations.");
+  hessianSymmetry.setDefaultValue(true);
+  this->_fields.push_back(XtbSettingsNames::hessianSymmetry, hessianSymmetry);
+
+  DoubleDescriptor hessianSymmetryTolerance("The maximum deviation of an atom from its symmetry image in bohr for "
+                                            "the point group detection of the numerical Hessian.");
+  hessianSymmetryTolerance.setMinimum(0.0);
+  hessianSymmetryTolerance.setDefaultValue(1e-3);
+  this->_fields.push_back(XtbSettingsNames::hessianSymmetryTolerance, hessianSymmetryTolerance);
+
+  OptionListDescriptor hessianDifferences("The finite differences of the numerical Hessian, 'central' or 'forward' "
+                                          "(half the gradients, less accurate).");
+  hessianDifferences.addOption("central");
+  hessianDifferences.addOption("forward");
+  hessianDifferences.setDefaultOption("central");
+  this->_fields.push_back(XtbSettingsNames::hessianDifferences, hessianDifferences);
+
+  OptionListDescriptor hessianUpdate("The update of the last Hessian with the change of the gradients instead of "
+                                     "an exact Hessian, 'none', 'bofill', 'powell' or 'bfgs'. Bofill and Powell are "
+                                     "suited for transition state searches, BFGS keeps a minimum positive definite.");
+  hessianUpdate.addOption("none");
+  hessianUpdate.addOption("bofill");
+  hessianUpdate.addOption("powell");
+  hessianUpdate.addOption("bfgs");
+  hessianUpdate.setDefaultOption("none");
+  this->_fields.push_back(XtbSettingsNames::hessianUpdate, hessianUpdate);
+
+  IntDescriptor hessianUpdateMaxSteps("The maximum number of consecutive Hessian updates before the Hessian is "
+                                      "calculated exactly again.");
+  hessianUpdateMaxSteps.setMinimum(1);
+  hessianUpdateMaxSteps.setDefaultValue(10);
+  this->_fields.push_back(XtbSettingsNames::hessianUpdateMaxSteps, hessianUpdateMaxSteps);
+
+  DoubleDescriptor hessianUpdateThreshold("The maximum relative error of the change of the gradients predicted by "
+                                          "the last Hessian, above which the Hessian is calculated exactly.");
+  hessianUpdateThreshold.setMinimum(0.0);
+  hessianUpdateThreshold.setDefaultValue(0.5);
+  this->_fields.push_back(XtbSettingsNames::hessianUpdateThreshold, hessianUpdateThreshold);
+
   // Parallel execution
   IntDescriptor parallel("The maximum number of cores to be used.");
-#if defined(_OPENMP)
-#  pragma omp parallel
-  { parallel.setDefaultValue(omp_get_num_threads()); }
-#else
-  parallel.setDefaultValue(1);
-#endif
+  parallel.setDefaultValue(defaultNumberOfThreads());
   this->_fields.push_back(SettingsNames::externalProgramNProcs, parallel);
 
   this->resetToDefaults();
@@ -13,6 +13,25 @@
 namespace Scine {
 namespace Xtb {
 
+namespace XtbSettingsNames {
+static constexpr const char* memoryLimit = "memory_limit";
+static constexpr const char* memoryLimitPolicy = "memory_limit_policy";
+static constexpr const char* restartDirectory = "restart_directory";
+static constexpr const char* timeLimit = "time_limit";
+static constexpr const char* hessianSymmetry = "hessian_symmetry";
+static constexpr const char* hessianSymmetryTolerance = "hessian_symmetry_tolerance";
+static constexpr const char* hessianDifferences = "hessian_differences";
+static constexpr const char* hessianUpdate = "hessian_update";
+static constexpr const char* hessianUpdateMaxSteps = "hessian_update_max_steps";
+static constexpr const char* hessianUpdateThreshold = "hessian_update_threshold";
+static constexpr const char* outputMode = "output_mode";
+static constexpr const char* outputBufferSize = "output_buffer_size";
+static constexpr const char* solvationGridPoints = "solvation_grid_points";
+static constexpr const char* scfRecovery = "scf_recovery";
+static constexpr const char* scfRecoveryTemperature = "scf_recovery_temperature";
+static constexpr const char* scfRecoveryIterationFactor = "scf_recovery_iteration_factor";
+} // namespace XtbSettingsNames
+
 /**
  * @class
  * @brief The SCINE State for Xtb.
@@ -21,8 +40,18 @@ class XtbSettings : public Scine::Utils::Settings {
  public:
   /**
    * @brief Construct a new XtbSettings object.
+   *
+   * The descriptors are built once per process and copied from there, so
+   * constructing settings neither assembles the descriptors nor detects the
+   * number of threads again.
    */
   XtbSettings();
+
+ private:
+  struct Schema {};
+  // Builds the descriptors and the defaults
+  explicit XtbSettings(Schema tag);
+  static const XtbSettings& _schema();
 };
 
 } /* namespace Xtb */